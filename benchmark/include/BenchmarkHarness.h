@@ -0,0 +1,118 @@
+#ifndef BREAKTHEDEPENDENCY_BENCHMARKHARNESS_H
+#define BREAKTHEDEPENDENCY_BENCHMARKHARNESS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+/// Keeps the compiler from optimizing away a value that only a benchmark uses
+template<typename T>
+inline void doNotOptimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/// Times `iterations` calls of `function` and returns the average of the
+/// fastest of a few repetitions, the one least disturbed by the rest of the
+/// system
+template<typename Function>
+double measureNanosecondsPerCall(std::size_t iterations, Function&& function)
+{
+    constexpr auto kRepetitions = 5;
+
+    auto fastest = std::chrono::steady_clock::duration::max();
+    for (auto repetition = 0; repetition < kRepetitions; ++repetition)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t iteration = 0; iteration < iterations; ++iteration)
+        {
+            function();
+        }
+        fastest = std::min(fastest, std::chrono::steady_clock::now() - start);
+    }
+
+    return std::chrono::duration<double, std::nano>{fastest}.count()
+           / static_cast<double>(iterations);
+}
+
+inline void reportMeasurement(std::string_view subject,
+                              std::string_view measurement,
+                              double value,
+                              std::string_view unit)
+{
+    std::cout << std::left << std::setw(24) << subject << std::setw(16)
+              << measurement << std::right << std::fixed
+              << std::setprecision(2) << std::setw(12) << value << ' ' << unit
+              << '\n';
+}
+
+inline void reportBenchmark(std::string_view strategy,
+                            std::string_view benchmark,
+                            double nanosecondsPerCall)
+{
+    reportMeasurement(strategy, benchmark, nanosecondsPerCall, "ns/call");
+}
+
+/// Nearest-rank percentile, reorders `samples`
+template<typename Duration>
+Duration percentile(std::vector<Duration>& samples, double percent)
+{
+    if (samples.empty())
+    {
+        return {};
+    }
+
+    const auto rank = static_cast<std::size_t>(
+        percent / 100.0 * static_cast<double>(samples.size() - 1) + 0.5);
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+
+    return samples[rank];
+}
+
+inline void warnIfNotOptimized()
+{
+#ifndef __OPTIMIZE__
+    std::cerr << "warning: built without optimization, the numbers are only "
+                 "meaningful with -DCMAKE_BUILD_TYPE=Release\n";
+#endif
+}
+
+/// Measures the hot path and the construction of a controller that is wired
+/// to a sink which discards everything. `makeController` returns an owning
+/// pointer to something with turnOnCamera() and turnOffCamera(), including
+/// whatever the strategy needs to be injected.
+template<typename MakeController>
+void runCameraPowerControllerBenchmarks(std::string_view strategy,
+                                        MakeController makeController)
+{
+    constexpr std::size_t kCallIterations = 10'000'000;
+    constexpr std::size_t kConstructionIterations = 100'000;
+
+    warnIfNotOptimized();
+
+    auto controller = makeController();
+    reportBenchmark(strategy,
+                    "turnOnCamera",
+                    measureNanosecondsPerCall(
+                        kCallIterations, [&controller] {
+                            controller->turnOnCamera();
+                        }));
+    reportBenchmark(strategy,
+                    "turnOffCamera",
+                    measureNanosecondsPerCall(
+                        kCallIterations, [&controller] {
+                            controller->turnOffCamera();
+                        }));
+    reportBenchmark(strategy,
+                    "construction",
+                    measureNanosecondsPerCall(
+                        kConstructionIterations, [&makeController] {
+                            doNotOptimize(makeController());
+                        }));
+}
+
+#endif // BREAKTHEDEPENDENCY_BENCHMARKHARNESS_H
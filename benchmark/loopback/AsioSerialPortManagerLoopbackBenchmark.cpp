@@ -0,0 +1,105 @@
+#include <atomic>
+#include <chrono>
+#include <string_view>
+#include <vector>
+
+#include "AsioSerialPortManager.h"
+#include "BenchmarkHarness.h"
+#include "SimulatedSerialDevice.h"
+
+using namespace std::literals;
+
+namespace
+{
+constexpr auto kBaudRate = 115200;
+constexpr std::size_t kMessageBytes = std::string_view{"ON"}.size();
+
+struct Scenario
+{
+    std::string_view name;
+    SimulatedSerialDevice::Behaviour behaviour;
+    std::size_t throughputMessages;
+    std::size_t latencySamples;
+};
+
+std::vector<Scenario> getScenarios()
+{
+    SimulatedSerialDevice::Behaviour unpaced;
+    SimulatedSerialDevice::Behaviour paced;
+    paced.baudRate = kBaudRate;
+    SimulatedSerialDevice::Behaviour pacedWithLatency = paced;
+    pacedWithLatency.latency = 1ms;
+    SimulatedSerialDevice::Behaviour slow;
+    slow.baudRate = 9600;
+
+    return {{"unpaced", unpaced, 100'000, 2'000},
+            {"115200 baud", paced, 5'000, 1'000},
+            {"115200 baud +1ms", pacedWithLatency, 5'000, 500},
+            {"9600 baud", slow, 500, 200}};
+}
+
+void runScenario(const Scenario& scenario)
+{
+    std::atomic<std::chrono::steady_clock::time_point> lastReceivedAt{};
+    SimulatedSerialDevice simulatedSerialDevice{
+        scenario.behaviour,
+        [&lastReceivedAt](std::string_view,
+                          std::chrono::steady_clock::time_point receivedAt) {
+            lastReceivedAt.store(receivedAt);
+        }};
+    AsioSerialPortManager asioSerialPortManager{
+        simulatedSerialDevice.serialDevice(), kBaudRate};
+    asioSerialPortManager.start();
+    asioSerialPortManager.warmUp().get();
+
+    std::size_t bytesSent = 0;
+    const auto throughputStart = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < scenario.throughputMessages; ++i)
+    {
+        asioSerialPortManager.asyncWrite("ON");
+    }
+    bytesSent += scenario.throughputMessages * kMessageBytes;
+    simulatedSerialDevice.waitForBytesFromHost(bytesSent, 1min);
+    const std::chrono::duration<double> throughputElapsed
+        = lastReceivedAt.load() - throughputStart;
+    reportMeasurement(scenario.name,
+                      "throughput",
+                      static_cast<double>(scenario.throughputMessages)
+                          / throughputElapsed.count(),
+                      "msg/s");
+
+    // One message at a time, so that each of them measures the whole trip
+    // from the call to the device rather than the time spent in the queue
+    std::vector<std::chrono::steady_clock::duration> latencies;
+    latencies.reserve(scenario.latencySamples);
+    for (std::size_t i = 0; i < scenario.latencySamples; ++i)
+    {
+        const auto sentAt = std::chrono::steady_clock::now();
+        asioSerialPortManager.asyncWrite("ON");
+        bytesSent += kMessageBytes;
+        simulatedSerialDevice.waitForBytesFromHost(bytesSent);
+        latencies.push_back(lastReceivedAt.load() - sentAt);
+    }
+    for (const auto percent : {50.0, 99.0})
+    {
+        const std::chrono::duration<double, std::micro> latency
+            = percentile(latencies, percent);
+        reportMeasurement(scenario.name,
+                          percent == 50.0 ? "p50 latency" : "p99 latency",
+                          latency.count(),
+                          "us");
+    }
+}
+} // namespace
+
+int main()
+{
+    warnIfNotOptimized();
+
+    for (const auto& scenario : getScenarios())
+    {
+        runScenario(scenario);
+    }
+
+    return 0;
+}
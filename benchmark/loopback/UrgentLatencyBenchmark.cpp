@@ -0,0 +1,162 @@
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "AsioSerialPortManager.h"
+#include "BenchmarkHarness.h"
+#include "SimulatedSerialDevice.h"
+
+using namespace std::literals;
+
+namespace
+{
+constexpr auto kBaudRate                     = 115200;
+constexpr std::size_t kMaxBatchBytes         = 512;
+constexpr std::size_t kMaxDriverBacklogBytes = 64;
+constexpr std::size_t kBulkMessageBytes      = 32;
+constexpr std::size_t kUrgentSamples         = 20;
+constexpr std::size_t kNormalSamples         = 5;
+constexpr std::size_t kUrgentMessageBytes    = std::string_view{"!"}.size();
+// Spreads the samples over the phases of the pseudo-terminal buffer, which
+// takes bytes in bursts whenever the device has drained it
+constexpr auto kSampleSpacing                = 37ms;
+
+using Latencies = std::vector<std::chrono::steady_clock::duration>;
+
+/// Bulk traffic only consists of dots, so any other byte is a probe
+class ProbeArrivals
+{
+public:
+    void onReceived(std::string_view bytes,
+                    std::chrono::steady_clock::time_point receivedAt)
+    {
+        if (bytes.find_first_not_of('.') != std::string_view::npos)
+        {
+            mArrivedAt.store(receivedAt);
+            ++mArrivals;
+            mArrivals.notify_all();
+        }
+    }
+
+    /// Time from handing a probe over to `write` until the device received
+    /// it, including the time the bytes already buffered by the serial port
+    /// take to drain
+    template<typename Write>
+    std::chrono::steady_clock::duration measure(Write write)
+    {
+        const auto arrivals = mArrivals.load();
+        const auto sentAt   = std::chrono::steady_clock::now();
+        write();
+        mArrivals.wait(arrivals);
+
+        return mArrivedAt.load() - sentAt;
+    }
+
+private:
+    std::atomic<std::size_t> mArrivals{0};
+    std::atomic<std::chrono::steady_clock::time_point> mArrivedAt{};
+};
+
+void reportLatencies(std::string_view subject, Latencies& latencies)
+{
+    for (const auto percent : {50.0, 100.0})
+    {
+        const std::chrono::duration<double, std::micro> latency
+            = percentile(latencies, percent);
+        reportMeasurement(subject,
+                          percent == 50.0 ? "p50 latency" : "max latency",
+                          latency.count(),
+                          "us");
+    }
+}
+} // namespace
+
+/// Keeps the queue of a manager full of bulk messages, as fast as a device
+/// paced at kBaudRate takes them, and measures how long urgent messages and
+/// normal ones take to reach the device through it
+int main()
+{
+    warnIfNotOptimized();
+
+    ProbeArrivals probeArrivals;
+    SimulatedSerialDevice::Behaviour paced;
+    paced.baudRate = kBaudRate;
+    SimulatedSerialDevice simulatedSerialDevice{
+        paced,
+        [&probeArrivals](std::string_view bytes,
+                         std::chrono::steady_clock::time_point receivedAt) {
+            probeArrivals.onReceived(bytes, receivedAt);
+        }};
+    AsioSerialPortManager asioSerialPortManager{
+        simulatedSerialDevice.serialDevice(), kBaudRate};
+    asioSerialPortManager.setBatchingPolicy(
+        {{}, kMaxBatchBytes, kMaxDriverBacklogBytes});
+    asioSerialPortManager.start();
+    asioSerialPortManager.warmUp().get();
+
+    std::atomic<bool> saturating{true};
+    std::atomic<std::size_t> bulkMessagesWritten{0};
+    std::thread bulkProducer{[&] {
+        const auto bulkMessage
+            = SerialMessage::copyOf(std::string(kBulkMessageBytes, '.'));
+        while (saturating.load())
+        {
+            // Blocks whenever the queue is full
+            asioSerialPortManager.asyncWrite(
+                bulkMessage,
+                [&bulkMessagesWritten](std::error_code, std::size_t) {
+                    ++bulkMessagesWritten;
+                });
+        }
+    }};
+    // Lets the queue and the pseudo-terminal buffer fill up
+    std::this_thread::sleep_for(500ms);
+
+    const auto saturatedSince     = std::chrono::steady_clock::now();
+    const auto bulkMessagesBefore = bulkMessagesWritten.load();
+    Latencies urgentLatencies;
+    for (std::size_t i = 0; i < kUrgentSamples; ++i)
+    {
+        std::this_thread::sleep_for(kSampleSpacing);
+        urgentLatencies.push_back(probeArrivals.measure(
+            [&] { asioSerialPortManager.asyncWriteUrgent("!"); }));
+    }
+    Latencies normalLatencies;
+    for (std::size_t i = 0; i < kNormalSamples; ++i)
+    {
+        std::this_thread::sleep_for(kSampleSpacing);
+        normalLatencies.push_back(probeArrivals.measure(
+            [&] { asioSerialPortManager.asyncWrite("?"); }));
+    }
+    const std::chrono::duration<double> saturatedFor
+        = std::chrono::steady_clock::now() - saturatedSince;
+    const auto bulkMessages = bulkMessagesWritten.load() - bulkMessagesBefore;
+
+    saturating.store(false);
+    bulkProducer.join();
+    asioSerialPortManager.stop();
+
+    reportMeasurement("bulk",
+                      "throughput",
+                      static_cast<double>(bulkMessages) / saturatedFor.count(),
+                      "msg/s");
+    reportLatencies("urgent", urgentLatencies);
+    reportLatencies("normal", normalLatencies);
+    // An urgent message waits for the batch being written at most, and for
+    // the driver backlog the manager lets build up ahead of it, then goes out
+    // in a batch of its own, all at ten bits per byte. The simulated device
+    // hands over what it took in together, which can add another batch. Normal
+    // ones queue behind the bulk messages as well.
+    const std::chrono::duration<double, std::micro> queueBound
+        = std::chrono::duration<double>{
+            static_cast<double>((kMaxBatchBytes + kMaxDriverBacklogBytes
+                                 + kUrgentMessageBytes)
+                                * 10)
+            / kBaudRate};
+    reportMeasurement("urgent", "queue bound", queueBound.count(), "us");
+
+    return 0;
+}
@@ -0,0 +1,20 @@
+#include "AsioSerialPortManager.h"
+#include "BenchmarkHarness.h"
+
+// Link-time stand-in for the real AsioSerialPortManager that discards every
+// message, so that the link-time strategies can be measured without a port.
+// Without any state of its own the manager is only what the strategy keeps
+// of it, a pointer.
+
+struct AsioSerialPortManager::Impl
+{
+};
+
+AsioSerialPortManager::AsioSerialPortManager(std::filesystem::path, int) {}
+
+AsioSerialPortManager::~AsioSerialPortManager() = default;
+
+void AsioSerialPortManager::asioWrite(SerialMessage message)
+{
+    doNotOptimize(message.data());
+}
@@ -0,0 +1,43 @@
+#include <future>
+#include <memory>
+
+#include "BenchmarkHarness.h"
+#include "CameraPowerController.h"
+#include "SerialPortManagerFactory.h"
+
+namespace
+{
+struct NullSerialPortManager : public SerialPortManager
+{
+    void asioWrite(SerialMessage message) override
+    {
+        doNotOptimize(message.data());
+    }
+
+    std::future<void> warmUp() override
+    {
+        return {};
+    }
+};
+
+struct NullSerialPortManagerFactory : public SerialPortManagerFactory
+{
+    std::unique_ptr<SerialPortManager> get(std::filesystem::path,
+                                           int) const override
+    {
+        return std::make_unique<NullSerialPortManager>();
+    }
+};
+
+NullSerialPortManagerFactory nullSerialPortManagerFactory;
+} // namespace
+
+int main()
+{
+    runCameraPowerControllerBenchmarks("di_factory", [] {
+        return std::make_unique<CameraPowerController>(
+            &nullSerialPortManagerFactory, ProductVariant::A);
+    });
+
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include <memory>
+
+#include "BenchmarkHarness.h"
+#include "CameraPowerController.h"
+#include "SerialPortAdapter.h"
+#include "SerialPortSink.h"
+
+namespace
+{
+struct NullSerialPortAdapter : public SerialPortAdapter
+{
+    void send(SerialMessage message) override
+    {
+        doNotOptimize(message.data());
+    }
+};
+
+struct FinalNullSerialPortAdapter final : public SerialPortAdapter
+{
+    void send(SerialMessage message) override
+    {
+        doNotOptimize(message.data());
+    }
+};
+
+struct NullSerialPort
+{
+    void write(SerialMessage message)
+    {
+        doNotOptimize(message.data());
+    }
+};
+
+template<typename SerialPortAdapterType>
+struct NullSinkCameraPowerController
+{
+    void turnOnCamera()
+    {
+        cameraPowerController.turnOnCamera();
+    }
+
+    void turnOffCamera()
+    {
+        cameraPowerController.turnOffCamera();
+    }
+
+    SerialPortAdapterType serialPortAdapter;
+    CameraPowerController cameraPowerController{&serialPortAdapter};
+};
+
+struct BoundNullSinkCameraPowerController
+{
+    void turnOnCamera()
+    {
+        cameraPowerController.turnOnCamera();
+    }
+
+    void turnOffCamera()
+    {
+        cameraPowerController.turnOffCamera();
+    }
+
+    NullSerialPort serialPort;
+    CameraPowerController cameraPowerController{
+        SerialPortSink::bind<&NullSerialPort::write>(&serialPort)};
+};
+} // namespace
+
+int main()
+{
+    runCameraPowerControllerBenchmarks("di_polymorphism", [] {
+        return std::make_unique<
+            NullSinkCameraPowerController<NullSerialPortAdapter>>();
+    });
+    runCameraPowerControllerBenchmarks("di_polymorphism final", [] {
+        return std::make_unique<
+            NullSinkCameraPowerController<FinalNullSerialPortAdapter>>();
+    });
+    runCameraPowerControllerBenchmarks("di_polymorphism bound", [] {
+        return std::make_unique<BoundNullSinkCameraPowerController>();
+    });
+
+    return 0;
+}
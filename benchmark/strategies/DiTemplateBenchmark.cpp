@@ -0,0 +1,42 @@
+#include <memory>
+
+#include "BenchmarkHarness.h"
+#include "CameraPowerController.h"
+#include "SerialMessage.h"
+
+namespace
+{
+struct NullSerialPortManager
+{
+    void asioWrite(SerialMessage message)
+    {
+        doNotOptimize(message.data());
+    }
+};
+
+struct NullSinkCameraPowerController
+{
+    void turnOnCamera()
+    {
+        cameraPowerController.turnOnCamera();
+    }
+
+    void turnOffCamera()
+    {
+        cameraPowerController.turnOffCamera();
+    }
+
+    NullSerialPortManager serialPortManager;
+    CameraPowerController<NullSerialPortManager> cameraPowerController{
+        &serialPortManager};
+};
+} // namespace
+
+int main()
+{
+    runCameraPowerControllerBenchmarks("di_template", [] {
+        return std::make_unique<NullSinkCameraPowerController>();
+    });
+
+    return 0;
+}
@@ -0,0 +1,15 @@
+#include <memory>
+
+#include "BenchmarkHarness.h"
+#include "CameraPowerController.h"
+
+int main()
+{
+    // AsioSerialPortManager comes from the null_asio_serial_port_manager
+    // target, so the controller writes to nowhere
+    runCameraPowerControllerBenchmarks("link_switch", [] {
+        return std::make_unique<CameraPowerController>(ProductVariant::A);
+    });
+
+    return 0;
+}
@@ -0,0 +1,17 @@
+#include <memory>
+
+#include "AsioSerialPortManager.h"
+#include "BenchmarkHarness.h"
+#include "CameraPowerController.h"
+
+int main()
+{
+    // AsioSerialPortManager comes from the null_asio_serial_port_manager
+    // target, so the controller writes to nowhere
+    runCameraPowerControllerBenchmarks("link_switch_template", [] {
+        return std::make_unique<CameraPowerController<AsioSerialPortManager>>(
+            kProductVariant<ProductVariant::A>);
+    });
+
+    return 0;
+}
@@ -0,0 +1,242 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <latch>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "AsioSerialPortManager.h"
+#include "BenchmarkHarness.h"
+#include "CameraPowerController.h"
+#include "FleetPowerController.h"
+#include "SimulatedSerialDevice.h"
+
+namespace
+{
+constexpr std::array<std::size_t, 6> kProducerCounts{1, 2, 4, 8, 16, 32};
+constexpr std::size_t kCommandsPerProducer = 20'000;
+constexpr auto kBaudRate                   = 9600;
+constexpr std::size_t kSharedPorts         = 4;
+constexpr std::size_t kCamerasPerPort      = 8;
+constexpr std::size_t kCameras             = kSharedPorts * kCamerasPerPort;
+
+using Latencies = std::vector<std::chrono::steady_clock::duration>;
+
+struct StressResult
+{
+    double commandsPerSecond;
+    Latencies latencies;
+    /// Times the producers gave up the CPU to wait, e.g. for room in a full
+    /// queue or for a lock
+    long blockingWaits;
+    /// Not sent for being the state that was sent last
+    std::uint64_t skippedCommands;
+};
+
+long voluntaryContextSwitchesOfThisThread()
+{
+    rusage usage{};
+    getrusage(RUSAGE_THREAD, &usage);
+
+    return usage.ru_nvcsw;
+}
+
+/// Lets `producers` threads loose on `issue` at once, each of them issuing
+/// kCommandsPerProducer commands through `issue(producer, command)`, and
+/// times every call
+template<typename Issue>
+StressResult stress(std::size_t producers, Issue issue)
+{
+    std::vector<Latencies> latencies(producers);
+    std::vector<long> blockingWaits(producers, 0);
+    std::latch ready{static_cast<std::ptrdiff_t>(producers) + 1};
+    std::latch go{1};
+
+    std::vector<std::thread> threads;
+    for (std::size_t producer = 0; producer < producers; ++producer)
+    {
+        threads.emplace_back([&, producer] {
+            auto& ownLatencies = latencies[producer];
+            ownLatencies.reserve(kCommandsPerProducer);
+            ready.count_down();
+            go.wait();
+
+            const auto contextSwitchesBefore
+                = voluntaryContextSwitchesOfThisThread();
+            for (std::size_t command = 0; command < kCommandsPerProducer;
+                 ++command)
+            {
+                const auto issuedAt = std::chrono::steady_clock::now();
+                issue(producer, command);
+                ownLatencies.push_back(std::chrono::steady_clock::now()
+                                       - issuedAt);
+            }
+            blockingWaits[producer] = voluntaryContextSwitchesOfThisThread()
+                                      - contextSwitchesBefore;
+        });
+    }
+
+    ready.arrive_and_wait();
+    const auto start = std::chrono::steady_clock::now();
+    go.count_down();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    const std::chrono::duration<double> elapsed
+        = std::chrono::steady_clock::now() - start;
+
+    StressResult result{
+        static_cast<double>(producers * kCommandsPerProducer)
+            / elapsed.count(),
+        {},
+        0,
+        0};
+    for (std::size_t producer = 0; producer < producers; ++producer)
+    {
+        result.latencies.insert(result.latencies.end(),
+                                latencies[producer].begin(),
+                                latencies[producer].end());
+        result.blockingWaits += blockingWaits[producer];
+    }
+
+    return result;
+}
+
+void report(std::string_view scenario,
+            std::size_t producers,
+            StressResult& result,
+            double singleProducerThroughput)
+{
+    const auto subject
+        = std::string{scenario} + " x" + std::to_string(producers);
+    const auto commands = static_cast<double>(producers * kCommandsPerProducer);
+    reportMeasurement(subject, "throughput", result.commandsPerSecond, "cmd/s");
+    reportMeasurement(subject,
+                      "speedup",
+                      result.commandsPerSecond / singleProducerThroughput,
+                      "x");
+    for (const auto& [percent, measurement] :
+         {std::pair{50.0, "p50 latency"},
+          std::pair{99.0, "p99 latency"},
+          std::pair{99.9, "p99.9 latency"}})
+    {
+        const std::chrono::duration<double, std::micro> latency
+            = percentile(result.latencies, percent);
+        reportMeasurement(subject, measurement, latency.count(), "us");
+    }
+    reportMeasurement(subject,
+                      "blocking waits",
+                      static_cast<double>(result.blockingWaits) * 1000.0
+                          / commands,
+                      "/1k cmd");
+    reportMeasurement(subject,
+                      "skipped",
+                      static_cast<double>(result.skippedCommands) * 100.0
+                          / commands,
+                      "%");
+}
+
+/// Every producer toggles the same camera, which is what the controller's
+/// deduplication and coalescing of power commands are contended on
+StressResult stressOneController(std::size_t producers)
+{
+    SimulatedSerialDevice simulatedSerialDevice;
+    CameraPowerController cameraPowerController{
+        ProductVariant::A, simulatedSerialDevice.serialDevice()};
+    cameraPowerController.warmUp().get();
+
+    auto result = stress(producers,
+                         [&cameraPowerController](std::size_t producer,
+                                                  std::size_t command) {
+                             if ((producer + command) % 2 == 0)
+                             {
+                                 cameraPowerController.turnOnCamera();
+                             }
+                             else
+                             {
+                                 cameraPowerController.turnOffCamera();
+                             }
+                         });
+    result.skippedCommands = cameraPowerController.skippedCommands();
+
+    return result;
+}
+
+/// The producers spread their commands over every camera, each of which
+/// shares its port and the port's writer with the other cameras on it
+StressResult stressSharedPorts(std::size_t producers)
+{
+    std::vector<std::unique_ptr<SimulatedSerialDevice>> simulatedSerialDevices;
+    FleetPowerController<AsioSerialPortManager> fleetPowerController;
+    for (std::size_t port = 0; port < kSharedPorts; ++port)
+    {
+        const auto& simulatedSerialDevice = simulatedSerialDevices.emplace_back(
+            std::make_unique<SimulatedSerialDevice>());
+        for (std::size_t camera = 0; camera < kCamerasPerPort; ++camera)
+        {
+            fleetPowerController.addCamera(
+                static_cast<CameraId>(port * kCamerasPerPort + camera),
+                simulatedSerialDevice->serialDevice(),
+                kBaudRate,
+                static_cast<std::uint8_t>(camera + 1));
+        }
+    }
+
+    auto result = stress(producers,
+                         [&fleetPowerController](std::size_t producer,
+                                                 std::size_t command) {
+                             const auto cameraId = static_cast<CameraId>(
+                                 (producer + command) % kCameras);
+                             if (command % 2 == 0)
+                             {
+                                 fleetPowerController.turnOnCamera(cameraId);
+                             }
+                             else
+                             {
+                                 fleetPowerController.turnOffCamera(cameraId);
+                             }
+                         });
+    fleetPowerController.drain();
+
+    return result;
+}
+} // namespace
+
+/// Issues mixed ON and OFF commands from a growing number of producer threads
+/// at once, against a single CameraPowerController and against a fleet of
+/// cameras sharing a few ports. The simulated devices take the bytes in as
+/// fast as they come, so what stops the numbers from scaling is the design
+/// rather than the serial line.
+int main()
+{
+    warnIfNotOptimized();
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency()
+              << '\n';
+
+    for (const auto& [scenario, run] :
+         {std::pair{"one controller", &stressOneController},
+          std::pair{"shared ports", &stressSharedPorts}})
+    {
+        double singleProducerThroughput = 0.0;
+        for (const auto producers : kProducerCounts)
+        {
+            auto result = run(producers);
+            if (producers == 1)
+            {
+                singleProducerThroughput = result.commandsPerSecond;
+            }
+            report(scenario, producers, result, singleProducerThroughput);
+        }
+    }
+
+    return 0;
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <future>
 #include <memory>
 
 #include "ProductVariant.h"
@@ -12,6 +13,9 @@ public:
     CameraPowerController(SerialPortManagerFactory* serialPortManagerFactory,
                           ProductVariant productVariant);
 
+    /// Opens the serial port without waiting for the first command
+    std::future<void> warmUp();
+
     void turnOnCamera();
     void turnOffCamera();
 
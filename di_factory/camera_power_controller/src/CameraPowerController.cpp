@@ -1,33 +1,18 @@
-#include <stdexcept>
-
 #include "CameraPowerController.h"
-
-namespace
-{
-const std::filesystem::path kSerialDevicePathForVariantA{
-    "/dev/CoolCompanyDevice"};
-const auto kBaudRateForVariantA = 9600;
-const std::filesystem::path kSerialDevicePathForVariantB{"COM3"};
-const auto kBaudRateForVariantB = 115200;
-} // namespace
+#include "ProductVariantTraits.h"
 
 CameraPowerController::CameraPowerController(
     SerialPortManagerFactory* serialPortManagerFactory,
     ProductVariant productVariant)
 {
-    switch (productVariant)
-    {
-    case ProductVariant::A:
-        mSerialPortManager = serialPortManagerFactory->get(
-            kSerialDevicePathForVariantA, kBaudRateForVariantA);
-        return;
-    case ProductVariant::B:
-        mSerialPortManager = serialPortManagerFactory->get(
-            kSerialDevicePathForVariantB, kBaudRateForVariantB);
-        return;
-    default:
-        throw std::logic_error("Unknown variant");
-    }
+    const auto& traits = getProductVariantTraits(productVariant);
+    mSerialPortManager
+        = serialPortManagerFactory->get(traits.serialDevice, traits.baudRate);
+}
+
+std::future<void> CameraPowerController::warmUp()
+{
+    return mSerialPortManager->warmUp();
 }
 
 void CameraPowerController::turnOnCamera()
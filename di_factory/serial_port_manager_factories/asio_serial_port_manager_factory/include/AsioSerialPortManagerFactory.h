@@ -1,13 +1,46 @@
 #ifndef BREAKTHEDEPENDENCY_ASIOSERIALPORTMANAGERFACTORY_H
 #define BREAKTHEDEPENDENCY_ASIOSERIALPORTMANAGERFACTORY_H
 
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+
 #include "SerialPortManagerFactory.h"
 
+/// Keeps the serial ports it opens in a pool keyed by device. The managers
+/// returned by get() are leases on a pooled port, so asking for the same port
+/// again does not reopen the device. A device runs at a single baud rate, so
+/// asking for another one reopens it at that rate if it is idle and throws
+/// std::invalid_argument while it is leased. A port is idle once its
+/// last lease has been released, however recently that lease wrote to it.
+/// Eviction is lazy: ports idle for longer than the idle timeout are only
+/// closed by the next get() or evictIdle(), until then they stay open.
 class AsioSerialPortManagerFactory : public SerialPortManagerFactory
 {
 public:
+    explicit AsioSerialPortManagerFactory(
+        std::chrono::steady_clock::duration idleTimeout = std::chrono::minutes{
+            1});
+    ~AsioSerialPortManagerFactory() override;
+
     std::unique_ptr<SerialPortManager> get(std::filesystem::path serialDevice,
                                            int baudRate) const override;
+
+    /// Closes the ports idle for longer than the idle timeout, e.g. from a
+    /// timer of the application when no get() may come for a while
+    void evictIdle() const;
+    std::size_t pooledPorts() const;
+
+private:
+    struct PooledPort;
+
+    void evictIdleLocked() const;
+
+    std::chrono::steady_clock::duration mIdleTimeout;
+    mutable std::mutex mPoolMutex;
+    mutable std::map<std::filesystem::path, std::shared_ptr<PooledPort>> mPool;
 };
 
 #endif // BREAKTHEDEPENDENCY_ASIOSERIALPORTMANAGERFACTORY_H
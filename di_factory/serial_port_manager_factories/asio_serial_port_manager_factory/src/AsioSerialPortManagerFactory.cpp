@@ -1,9 +1,112 @@
-#include "AsioSerialPortManagerFactory.h"
+#include <atomic>
+#include <stdexcept>
+
 #include "AsioSerialPortManager.h"
+#include "AsioSerialPortManagerFactory.h"
+
+struct AsioSerialPortManagerFactory::PooledPort
+{
+    PooledPort(const std::filesystem::path& serialDevice, int openedBaudRate)
+        : baudRate{openedBaudRate}
+        , asioSerialPortManager{serialDevice, openedBaudRate}
+    {
+    }
+
+    int baudRate;
+    AsioSerialPortManager asioSerialPortManager;
+    // Leases of the same port may be used from different threads
+    std::mutex writeMutex;
+    std::atomic<std::chrono::steady_clock::time_point> lastReleased{
+        std::chrono::steady_clock::now()};
+};
+
+namespace
+{
+template<typename PooledPort>
+class SerialPortManagerLease : public SerialPortManager
+{
+public:
+    SerialPortManagerLease(std::shared_ptr<PooledPort> pooledPort)
+        : mPooledPort{std::move(pooledPort)}
+    {
+    }
+
+    ~SerialPortManagerLease() override
+    {
+        mPooledPort->lastReleased.store(std::chrono::steady_clock::now());
+    }
+
+    void asioWrite(SerialMessage message) override
+    {
+        std::lock_guard lock{mPooledPort->writeMutex};
+        mPooledPort->asioSerialPortManager.asioWrite(std::move(message));
+    }
+
+    std::future<void> warmUp() override
+    {
+        return mPooledPort->asioSerialPortManager.warmUp();
+    }
+
+private:
+    std::shared_ptr<PooledPort> mPooledPort;
+};
+} // namespace
+
+AsioSerialPortManagerFactory::AsioSerialPortManagerFactory(
+    std::chrono::steady_clock::duration idleTimeout)
+    : mIdleTimeout{idleTimeout}
+{
+}
+
+AsioSerialPortManagerFactory::~AsioSerialPortManagerFactory() = default;
 
 std::unique_ptr<SerialPortManager>
 AsioSerialPortManagerFactory::get(std::filesystem::path serialDevice,
                                   int baudRate) const
 {
-    return std::make_unique<AsioSerialPortManager>(serialDevice, baudRate);
+    std::lock_guard lock{mPoolMutex};
+    evictIdleLocked();
+
+    auto& pooledPort = mPool[serialDevice];
+    if (pooledPort && pooledPort->baudRate != baudRate)
+    {
+        // The pool holds the only reference once every lease is gone
+        if (pooledPort.use_count() != 1)
+        {
+            throw std::invalid_argument(
+                "Serial device already leased at another baud rate");
+        }
+        pooledPort.reset();
+    }
+    if (!pooledPort)
+    {
+        pooledPort = std::make_shared<PooledPort>(serialDevice, baudRate);
+    }
+
+    return std::make_unique<SerialPortManagerLease<PooledPort>>(pooledPort);
+}
+
+void AsioSerialPortManagerFactory::evictIdle() const
+{
+    std::lock_guard lock{mPoolMutex};
+    evictIdleLocked();
+}
+
+std::size_t AsioSerialPortManagerFactory::pooledPorts() const
+{
+    std::lock_guard lock{mPoolMutex};
+
+    return mPool.size();
+}
+
+void AsioSerialPortManagerFactory::evictIdleLocked() const
+{
+    const auto now = std::chrono::steady_clock::now();
+    std::erase_if(mPool, [this, now](const auto& entry) {
+        const auto& pooledPort = entry.second;
+        // The pool holds the only reference once every lease is gone
+        return !pooledPort
+               || (pooledPort.use_count() == 1
+                   && now - pooledPort->lastReleased.load() >= mIdleTimeout);
+    });
 }
@@ -2,7 +2,7 @@
 #define BREAKTHEDEPENDENCY_ASIOSERIALPORTMANAGER_H
 
 #include <filesystem>
-#include <string_view>
+#include <mutex>
 
 #include <asio.hpp>
 
@@ -11,11 +11,20 @@
 class AsioSerialPortManager : public SerialPortManager
 {
 public:
+    /// The device is opened by the first write or by warmUp()
     AsioSerialPortManager(std::filesystem::path serialDevice, int baudRate);
 
-    void asioWrite(std::string_view message) override;
+    void asioWrite(SerialMessage message) override;
+    /// Opens the device on a thread of its own. The manager has to outlive
+    /// the returned future.
+    std::future<void> warmUp() override;
 
 private:
+    void openIfNeeded();
+
+    std::filesystem::path mSerialDevice;
+    int mBaudRate;
+    std::once_flag mOpened;
     asio::io_service mIoService;
     asio::serial_port mSerialPort{mIoService};
 };
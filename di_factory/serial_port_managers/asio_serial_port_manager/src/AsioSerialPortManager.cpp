@@ -1,14 +1,40 @@
+#include <utility>
+
 #include "AsioSerialPortManager.h"
 
 AsioSerialPortManager::AsioSerialPortManager(std::filesystem::path serialDevice,
                                              int baudRate)
+    : mSerialDevice{std::move(serialDevice)}
+    , mBaudRate{baudRate}
+{
+}
+
+void AsioSerialPortManager::asioWrite(SerialMessage message)
+{
+    openIfNeeded();
+    asio::write(mSerialPort, asio::buffer(message.data(), message.size()));
+}
+
+std::future<void> AsioSerialPortManager::warmUp()
 {
-    mSerialPort.open(serialDevice.c_str());
-    mSerialPort.set_option(
-        asio::serial_port_base::baud_rate(static_cast<unsigned int>(baudRate)));
+    return std::async(std::launch::async, [this] { openIfNeeded(); });
 }
 
-void AsioSerialPortManager::asioWrite(std::string_view message)
+void AsioSerialPortManager::openIfNeeded()
 {
-    asio::write(mSerialPort, asio::buffer(message));
+    // A failed open throws out of call_once, so the next call tries again
+    std::call_once(mOpened, [this] {
+        mSerialPort.open(mSerialDevice.string());
+        std::error_code error;
+        mSerialPort.set_option(asio::serial_port_base::baud_rate(
+                                   static_cast<unsigned int>(mBaudRate)),
+                               error);
+        // Otherwise the next call would find the port open already
+        if (error)
+        {
+            std::error_code ignored;
+            mSerialPort.close(ignored);
+            throw std::system_error{error};
+        }
+    });
 }
@@ -1,13 +1,17 @@
 #ifndef BREAKTHEDEPENDENCY_SERIALPORTMANAGER_H
 #define BREAKTHEDEPENDENCY_SERIALPORTMANAGER_H
 
-#include <string_view>
+#include <future>
+
+#include "SerialMessage.h"
 
 struct SerialPortManager
 {
     virtual ~SerialPortManager() = default;
 
-    virtual void asioWrite(std::string_view message) = 0;
+    virtual void asioWrite(SerialMessage message) = 0;
+    /// Opens the port ahead of the first write, the future throws if it fails
+    virtual std::future<void> warmUp() = 0;
 };
 
 #endif // BREAKTHEDEPENDENCY_SERIALPORTMANAGER_H
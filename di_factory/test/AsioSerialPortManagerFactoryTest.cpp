@@ -0,0 +1,190 @@
+#include <cerrno>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "AsioSerialPortManagerFactory.h"
+#include "SimulatedSerialDeviceFixture.h"
+
+namespace
+{
+const auto kBaudRate = 9600;
+const auto kOtherBaudRate = 115200;
+const auto kUnsupportedBaudRate = 12345;
+const std::filesystem::path kMissingSerialDevice{"/dev/NoSuchCoolCompanyDevice"};
+} // namespace
+
+struct AsioSerialPortManagerFactoryTest : public SimulatedSerialDeviceFixture
+{
+    std::string readFromDevice(std::size_t bytes)
+    {
+        mSimulatedSerialDevice.waitForBytesFromHost(bytes);
+        return mSimulatedSerialDevice.received();
+    }
+
+    speed_t deviceSpeed() const
+    {
+        const auto fileDescriptor
+            = ::open(mSerialDevice.c_str(), O_RDWR | O_NOCTTY);
+        termios attributes{};
+        EXPECT_EQ(::tcgetattr(fileDescriptor, &attributes), 0);
+        ::close(fileDescriptor);
+
+        return ::cfgetospeed(&attributes);
+    }
+};
+
+TEST_F(AsioSerialPortManagerFactoryTest,
+       get_WhenSamePortRequestedTwice_WillShareOnePooledPort)
+{
+    AsioSerialPortManagerFactory factory;
+
+    auto first = factory.get(mSerialDevice, kBaudRate);
+    auto second = factory.get(mSerialDevice, kBaudRate);
+
+    EXPECT_EQ(factory.pooledPorts(), 1U);
+}
+
+TEST_F(AsioSerialPortManagerFactoryTest,
+       get_WhenLeasedPortRequestedWithOtherBaudRate_WillThrow)
+{
+    AsioSerialPortManagerFactory factory;
+    auto lease = factory.get(mSerialDevice, kBaudRate);
+
+    EXPECT_THROW(factory.get(mSerialDevice, kOtherBaudRate),
+                 std::invalid_argument);
+    EXPECT_EQ(factory.pooledPorts(), 1U);
+}
+
+TEST_F(AsioSerialPortManagerFactoryTest,
+       get_WhenIdlePortRequestedWithOtherBaudRate_WillReopenItAtThatRate)
+{
+    AsioSerialPortManagerFactory factory;
+    factory.get(mSerialDevice, kBaudRate)->asioWrite("OFF");
+
+    auto lease = factory.get(mSerialDevice, kOtherBaudRate);
+    lease->asioWrite("ON");
+
+    EXPECT_EQ(factory.pooledPorts(), 1U);
+    EXPECT_EQ(readFromDevice(5), "OFFON");
+    EXPECT_EQ(deviceSpeed(), B115200);
+}
+
+TEST_F(AsioSerialPortManagerFactoryTest,
+       asioWrite_WhenBaudRateCannotBeSet_WillFailAgainOnTheNextWrite)
+{
+    AsioSerialPortManagerFactory factory;
+    auto lease = factory.get(mSerialDevice, kUnsupportedBaudRate);
+
+    for (auto write = 0; write < 2; ++write)
+    {
+        try
+        {
+            lease->asioWrite("ON");
+            ADD_FAILURE() << "Wrote at an unsupported baud rate";
+        }
+        catch (const std::system_error& error)
+        {
+            // Rather than complaining that the port is open already
+            EXPECT_EQ(error.code().value(), EINVAL);
+        }
+    }
+}
+
+TEST_F(AsioSerialPortManagerFactoryTest,
+       asioWrite_WhenCalledThroughSharedLeases_WillWriteToTheDevice)
+{
+    AsioSerialPortManagerFactory factory;
+    auto first = factory.get(mSerialDevice, kBaudRate);
+    auto second = factory.get(mSerialDevice, kBaudRate);
+
+    first->asioWrite("ON");
+    second->asioWrite("OFF");
+
+    EXPECT_EQ(readFromDevice(5), "ONOFF");
+}
+
+TEST_F(AsioSerialPortManagerFactoryTest,
+       evictIdle_WhenLeaseStillHeld_WillKeepPort)
+{
+    AsioSerialPortManagerFactory factory{std::chrono::steady_clock::duration{}};
+    auto lease = factory.get(mSerialDevice, kBaudRate);
+
+    factory.evictIdle();
+
+    EXPECT_EQ(factory.pooledPorts(), 1U);
+}
+
+TEST_F(AsioSerialPortManagerFactoryTest,
+       evictIdle_WhenLeasesReleasedPastIdleTimeout_WillClosePort)
+{
+    AsioSerialPortManagerFactory factory{std::chrono::steady_clock::duration{}};
+    factory.get(mSerialDevice, kBaudRate);
+
+    factory.evictIdle();
+
+    EXPECT_EQ(factory.pooledPorts(), 0U);
+}
+
+TEST_F(AsioSerialPortManagerFactoryTest,
+       evictIdle_WhenLeasesReleasedWithinIdleTimeout_WillKeepPort)
+{
+    AsioSerialPortManagerFactory factory{std::chrono::hours{1}};
+    factory.get(mSerialDevice, kBaudRate);
+
+    factory.evictIdle();
+
+    EXPECT_EQ(factory.pooledPorts(), 1U);
+}
+
+TEST_F(AsioSerialPortManagerFactoryTest,
+       get_WhenIdlePortEvicted_WillReopenDevice)
+{
+    AsioSerialPortManagerFactory factory{std::chrono::steady_clock::duration{}};
+    factory.get(mSerialDevice, kBaudRate);
+
+    auto lease = factory.get(mSerialDevice, kBaudRate);
+    lease->asioWrite("ON");
+
+    EXPECT_EQ(factory.pooledPorts(), 1U);
+    EXPECT_EQ(readFromDevice(2), "ON");
+}
+
+TEST_F(AsioSerialPortManagerFactoryTest,
+       get_WhenDeviceDoesNotExist_WillNotOpenItUntilFirstWrite)
+{
+    AsioSerialPortManagerFactory factory;
+
+    auto lease = factory.get(kMissingSerialDevice, kBaudRate);
+
+    EXPECT_THROW(lease->asioWrite("ON"), std::system_error);
+}
+
+TEST_F(AsioSerialPortManagerFactoryTest,
+       warmUp_WhenDeviceDoesNotExist_WillFailTheFuture)
+{
+    AsioSerialPortManagerFactory factory;
+    auto lease = factory.get(kMissingSerialDevice, kBaudRate);
+
+    auto warmedUp = lease->warmUp();
+
+    EXPECT_THROW(warmedUp.get(), std::system_error);
+}
+
+TEST_F(AsioSerialPortManagerFactoryTest,
+       warmUp_WhenDeviceExists_WillOpenItAheadOfFirstWrite)
+{
+    AsioSerialPortManagerFactory factory;
+    auto lease = factory.get(mSerialDevice, kBaudRate);
+
+    lease->warmUp().get();
+    lease->asioWrite("ON");
+
+    EXPECT_EQ(readFromDevice(2), "ON");
+}
@@ -83,3 +83,9 @@ TEST_F(CameraPowerControllerTest,
     EXPECT_CALL(*mSerialPortManager, asioWrite("OFF"sv));
     mCameraPowerController->turnOffCamera();
 }
+
+TEST_F(CameraPowerControllerTest, warmUp_WhenCalled_WillWarmUpSerialPortManager)
+{
+    EXPECT_CALL(*mSerialPortManager, warmUp());
+    mCameraPowerController->warmUp();
+}
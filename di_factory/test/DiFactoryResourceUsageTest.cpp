@@ -0,0 +1,69 @@
+#include <filesystem>
+#include <memory>
+#include <utility>
+
+#include "gtest/gtest.h"
+
+#include "AsioSerialPortManagerFactory.h"
+#include "CameraPowerController.h"
+#include "ResourceUsageFixture.h"
+#include "SimulatedSerialDevice.h"
+
+namespace
+{
+/// Hands out the pooled managers of AsioSerialPortManagerFactory, on the
+/// simulated device instead of the one of the product variant
+class RedirectingSerialPortManagerFactory : public SerialPortManagerFactory
+{
+public:
+    RedirectingSerialPortManagerFactory(std::filesystem::path serialDevice)
+        : mSerialDevice{std::move(serialDevice)}
+    {
+    }
+
+    std::unique_ptr<SerialPortManager> get(std::filesystem::path,
+                                           int baudRate) const override
+    {
+        return mAsioSerialPortManagerFactory.get(mSerialDevice, baudRate);
+    }
+
+private:
+    std::filesystem::path mSerialDevice;
+    AsioSerialPortManagerFactory mAsioSerialPortManagerFactory;
+};
+} // namespace
+
+struct DiFactoryResourceUsageTest : public ResourceUsageFixture
+{
+    DiFactoryResourceUsageTest()
+    {
+        // Opens the port, which is not what is measured
+        mCameraPowerController.turnOffCamera();
+    }
+
+    SimulatedSerialDevice mSimulatedSerialDevice;
+    RedirectingSerialPortManagerFactory mSerialPortManagerFactory{
+        mSimulatedSerialDevice.serialDevice()};
+    CameraPowerController mCameraPowerController{&mSerialPortManagerFactory,
+                                                 ProductVariant::A};
+};
+
+TEST_F(DiFactoryResourceUsageTest,
+       turnOnCamera_WhenPortOpen_WillNotAllocateAndWriteOnce)
+{
+    const auto resourceUsage
+        = measure([this] { mCameraPowerController.turnOnCamera(); });
+
+    EXPECT_EQ(resourceUsage.allocations, 0U) << resourceUsage;
+    EXPECT_EQ(resourceUsage.writeSyscalls, 1U) << resourceUsage;
+}
+
+TEST_F(DiFactoryResourceUsageTest,
+       turnOffCamera_WhenPortOpen_WillNotAllocateAndWriteOnce)
+{
+    const auto resourceUsage
+        = measure([this] { mCameraPowerController.turnOffCamera(); });
+
+    EXPECT_EQ(resourceUsage.allocations, 0U) << resourceUsage;
+    EXPECT_EQ(resourceUsage.writeSyscalls, 1U) << resourceUsage;
+}
@@ -7,7 +7,14 @@
 class MockSerialPortManager : public SerialPortManager
 {
 public:
-    MOCK_METHOD(void, asioWrite, (std::string_view message), (override));
+    MOCK_METHOD(void, asioWrite, (std::string_view message), ());
+    MOCK_METHOD(std::future<void>, warmUp, (), (override));
+
+    // Expectations are set on the payload rather than on the message type
+    void asioWrite(SerialMessage message) override
+    {
+        asioWrite(message.view());
+    }
 };
 
 #endif // BREAKTHEDEPENDENCY_MOCKSERIALPORTMANAGER_H
@@ -0,0 +1,38 @@
+#ifndef BREAKTHEDEPENDENCY_RECORDINGSERIALPORTMANAGER_H
+#define BREAKTHEDEPENDENCY_RECORDINGSERIALPORTMANAGER_H
+
+#include <future>
+#include <utility>
+
+#include "RecordingLog.h"
+#include "SerialPortManager.h"
+
+/// Records every message instead of writing it, from as many threads at once
+/// as there are, for load tests where a mock would be the bottleneck
+class RecordingSerialPortManager final : public SerialPortManager
+{
+public:
+    /// The log has to outlive the manager
+    explicit RecordingSerialPortManager(RecordingLog* recordingLog)
+        : mRecordingLog{recordingLog}
+    {
+    }
+
+    void asioWrite(SerialMessage message) override
+    {
+        mRecordingLog->record(std::move(message));
+    }
+
+    std::future<void> warmUp() override
+    {
+        std::promise<void> opened;
+        opened.set_value();
+
+        return opened.get_future();
+    }
+
+private:
+    RecordingLog* mRecordingLog;
+};
+
+#endif // BREAKTHEDEPENDENCY_RECORDINGSERIALPORTMANAGER_H
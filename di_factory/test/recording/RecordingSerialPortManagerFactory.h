@@ -0,0 +1,23 @@
+#ifndef BREAKTHEDEPENDENCY_RECORDINGSERIALPORTMANAGERFACTORY_H
+#define BREAKTHEDEPENDENCY_RECORDINGSERIALPORTMANAGERFACTORY_H
+
+#include <memory>
+
+#include "RecordingSerialPortManager.h"
+#include "RecordingSerialPorts.h"
+#include "SerialPortManagerFactory.h"
+
+/// Hands out RecordingSerialPortManager that record to the log of the device
+/// they are asked for, so that the managers of the same port share a log
+class RecordingSerialPortManagerFactory : public SerialPortManagerFactory
+{
+public:
+    std::unique_ptr<SerialPortManager> get(std::filesystem::path serialDevice,
+                                           int) const override
+    {
+        return std::make_unique<RecordingSerialPortManager>(
+            &RecordingSerialPorts::of(serialDevice.native()));
+    }
+};
+
+#endif // BREAKTHEDEPENDENCY_RECORDINGSERIALPORTMANAGERFACTORY_H
@@ -1,15 +1,16 @@
 #pragma once
 
 #include "SerialPortAdapter.h"
+#include "SerialPortSink.h"
 
 class CameraPowerController
 {
 public:
-    CameraPowerController(SerialPortAdapter* serialPortAdapter);
+    CameraPowerController(SerialPortSink serialPortSink);
 
     void turnOnCamera();
     void turnOffCamera();
 
 private:
-    SerialPortAdapter* mSerialPortAdapter;
+    SerialPortSink mSerialPortSink;
 };
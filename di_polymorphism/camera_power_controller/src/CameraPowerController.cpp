@@ -1,17 +1,16 @@
 #include "CameraPowerController.h"
 
-CameraPowerController::CameraPowerController(
-    SerialPortAdapter* serialPortAdapter)
-    : mSerialPortAdapter{serialPortAdapter}
+CameraPowerController::CameraPowerController(SerialPortSink serialPortSink)
+    : mSerialPortSink{serialPortSink}
 {
 }
 
 void CameraPowerController::turnOnCamera()
 {
-    mSerialPortAdapter->send("ON");
+    mSerialPortSink.send("ON");
 }
 
 void CameraPowerController::turnOffCamera()
 {
-    mSerialPortAdapter->send("OFF");
+    mSerialPortSink.send("OFF");
 }
@@ -1,34 +1,11 @@
-#include <utility>
-
 #include "AsioSerialPortAdapter.h"
 #include "AsioSerialPortManager.h"
 #include "CameraPowerController.h"
 #include "ProductVariant.h"
+#include "ProductVariantTraits.h"
 
 namespace
 {
-const std::filesystem::path kSerialDevicePathForVariantA{
-    "/dev/CoolCompanyDevice"};
-const auto kBaudRateForVariantA = 9600;
-const std::filesystem::path kSerialDevicePathForVariantB{"COM3"};
-const auto kBaudRateForVariantB = 115200;
-
-std::pair<std::filesystem::path, int>
-getAsioSerialPortManagerConfiguration(ProductVariant productVariant)
-{
-    switch (productVariant)
-    {
-    case ProductVariant::A:
-        return std::make_pair(kSerialDevicePathForVariantA,
-                              kBaudRateForVariantA);
-    case ProductVariant::B:
-        return std::make_pair(kSerialDevicePathForVariantB,
-                              kBaudRateForVariantB);
-    default:
-        throw std::logic_error("Unknown variant");
-    }
-}
-
 ProductVariant getProductVariant()
 {
 #if __linux__
@@ -41,10 +18,10 @@ ProductVariant getProductVariant()
 
 int main()
 {
-    const auto [serialDevice, baudRate]
-        = getAsioSerialPortManagerConfiguration(getProductVariant());
+    const auto& traits = getProductVariantTraits(getProductVariant());
 
-    AsioSerialPortManager asioSerialPortManager{serialDevice, baudRate};
+    AsioSerialPortManager asioSerialPortManager{traits.serialDevice,
+                                                traits.baudRate};
     AsioSerialPortAdapter asioSerialPortAdapter{&asioSerialPortManager};
     CameraPowerController cameraPowerController{&asioSerialPortAdapter};
     cameraPowerController.turnOnCamera();
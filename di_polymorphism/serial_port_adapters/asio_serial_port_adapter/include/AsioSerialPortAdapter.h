@@ -1,15 +1,22 @@
 #ifndef BREAKTHEDEPENDENCY_ASIOSERIALPORTADATER_H
 #define BREAKTHEDEPENDENCY_ASIOSERIALPORTADATER_H
 
+#include <utility>
+
 #include "AsioSerialPortManager.h"
 #include "SerialPortAdapter.h"
 
-class AsioSerialPortAdapter : public SerialPortAdapter
+/// Final and defined inline, so that sending through a SerialPortSink that
+/// refers to an AsioSerialPortAdapter goes straight to asioWrite()
+class AsioSerialPortAdapter final : public SerialPortAdapter
 {
 public:
     AsioSerialPortAdapter(AsioSerialPortManager* asioSerialPortManager);
 
-    void send(std::string_view message) override;
+    void send(SerialMessage message) override
+    {
+        mAsioSerialPortManager->asioWrite(std::move(message));
+    }
 
 private:
     AsioSerialPortManager* mAsioSerialPortManager;
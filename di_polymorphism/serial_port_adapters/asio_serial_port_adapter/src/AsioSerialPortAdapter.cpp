@@ -5,8 +5,3 @@ AsioSerialPortAdapter::AsioSerialPortAdapter(
     : mAsioSerialPortManager{asioSerialPortManager}
 {
 }
-
-void AsioSerialPortAdapter::send(std::string_view message)
-{
-    mAsioSerialPortManager->asioWrite(message);
-}
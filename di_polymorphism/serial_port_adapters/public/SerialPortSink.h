@@ -0,0 +1,66 @@
+#ifndef BREAKTHEDEPENDENCY_SERIALPORTSINK_H
+#define BREAKTHEDEPENDENCY_SERIALPORTSINK_H
+
+#include <concepts>
+#include <utility>
+
+#include "SerialMessage.h"
+
+template<typename Target>
+concept SerialPortSendable = requires(Target& target, SerialMessage message)
+{
+    target.send(std::move(message));
+};
+
+/// A non-owning, non-virtual handle to whatever sends serial messages, in the
+/// spirit of `function_ref`. It is two pointers wide and calls the target
+/// through a function pointer that is generated for its exact type, so
+/// calling a `final` class or a member bound with bind() costs one indirect
+/// call with the target's code inlined behind it, rather than a vtable lookup
+/// on top of that. Interfaces such as `SerialPortAdapter` and their mocks
+/// convert to it as they are. The target has to outlive the sink.
+class SerialPortSink
+{
+public:
+    template<SerialPortSendable Target>
+    SerialPortSink(Target* target)
+        : mTarget{target}
+        , mSend{[](void* erasedTarget, SerialMessage&& message) {
+            static_cast<Target*>(erasedTarget)->send(std::move(message));
+        }}
+    {
+    }
+
+    /// Sends through any member function, e.g.
+    /// `SerialPortSink::bind<&AsioSerialPortManager::asioWrite>(&manager)`
+    template<auto Send, typename Target>
+    requires std::invocable<decltype(Send), Target&, SerialMessage>
+    static SerialPortSink bind(Target* target)
+    {
+        return SerialPortSink{
+            target, [](void* erasedTarget, SerialMessage&& message) {
+                (static_cast<Target*>(erasedTarget)->*Send)(std::move(message));
+            }};
+    }
+
+    void send(SerialMessage message) const
+    {
+        mSend(mTarget, std::move(message));
+    }
+
+private:
+    // Takes the message by reference so that it is only moved once, into the
+    // target's own parameter
+    using Trampoline = void (*)(void* target, SerialMessage&& message);
+
+    SerialPortSink(void* target, Trampoline trampoline)
+        : mTarget{target}
+        , mSend{trampoline}
+    {
+    }
+
+    void* mTarget;
+    Trampoline mSend;
+};
+
+#endif // BREAKTHEDEPENDENCY_SERIALPORTSINK_H
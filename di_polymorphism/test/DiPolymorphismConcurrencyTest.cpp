@@ -0,0 +1,56 @@
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "CameraPowerController.h"
+#include "RecordingSerialPortAdapter.h"
+
+using namespace std::literals;
+
+namespace
+{
+constexpr std::size_t kThreads           = 4;
+constexpr std::size_t kCommandsPerThread = 10000;
+} // namespace
+
+struct DiPolymorphismConcurrencyTest : public ::testing::Test
+{
+    RecordingLog mRecordingLog;
+    RecordingSerialPortAdapter mRecordingSerialPortAdapter{&mRecordingLog};
+    CameraPowerController mCameraPowerController{&mRecordingSerialPortAdapter};
+};
+
+TEST_F(DiPolymorphismConcurrencyTest,
+       turnOnCamera_WhenSharedByManyThreads_WillSendAllInOrderOfEachThread)
+{
+    std::vector<std::thread> producers;
+    for (std::size_t i = 0; i < kThreads; ++i)
+    {
+        producers.emplace_back([this] {
+            for (std::size_t command = 0; command < kCommandsPerThread;
+                 ++command)
+            {
+                mCameraPowerController.turnOnCamera();
+                mCameraPowerController.turnOffCamera();
+            }
+        });
+    }
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+
+    const auto threadRecordings = mRecordingLog.byThread();
+    ASSERT_EQ(threadRecordings.size(), kThreads);
+    for (const auto& threadRecording : threadRecordings)
+    {
+        ASSERT_EQ(threadRecording.messages.size(), 2 * kCommandsPerThread);
+        for (std::size_t i = 0; i < threadRecording.messages.size(); ++i)
+        {
+            ASSERT_EQ(threadRecording.messages[i],
+                      i % 2 == 0 ? "ON"sv : "OFF"sv);
+        }
+    }
+}
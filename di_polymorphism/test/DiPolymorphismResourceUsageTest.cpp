@@ -0,0 +1,47 @@
+#include "gtest/gtest.h"
+
+#include "AsioSerialPortManager.h"
+#include "CameraPowerController.h"
+#include "ResourceUsageFixture.h"
+#include "SimulatedSerialDevice.h"
+
+struct DiPolymorphismResourceUsageTest : public ResourceUsageFixture
+{
+    DiPolymorphismResourceUsageTest()
+    {
+        // Opens the port, which is not what is measured
+        mCameraPowerController.turnOffCamera();
+    }
+
+    SimulatedSerialDevice mSimulatedSerialDevice;
+    AsioSerialPortManager mAsioSerialPortManager{
+        mSimulatedSerialDevice.serialDevice(), 9600};
+    CameraPowerController mCameraPowerController{
+        SerialPortSink::bind<&AsioSerialPortManager::asioWrite>(
+            &mAsioSerialPortManager)};
+};
+
+TEST_F(DiPolymorphismResourceUsageTest,
+       turnOnCamera_WhenPortOpen_WillExceedTheBudgetByTheManagersWrite)
+{
+    const auto resourceUsage
+        = measure([this] { mCameraPowerController.turnOnCamera(); });
+
+    // Over the budget of no allocations and a single write, by exactly the
+    // cost of the manager's blocking asioWrite(): five allocations and the
+    // reactor's two syscalls waiting for the write
+    EXPECT_EQ(resourceUsage.allocations, 5U) << resourceUsage;
+    EXPECT_EQ(resourceUsage.syscalls, 3U) << resourceUsage;
+    EXPECT_EQ(resourceUsage.writeSyscalls, 1U) << resourceUsage;
+}
+
+TEST_F(DiPolymorphismResourceUsageTest,
+       turnOffCamera_WhenPortOpen_WillExceedTheBudgetByTheManagersWrite)
+{
+    const auto resourceUsage
+        = measure([this] { mCameraPowerController.turnOffCamera(); });
+
+    EXPECT_EQ(resourceUsage.allocations, 5U) << resourceUsage;
+    EXPECT_EQ(resourceUsage.syscalls, 3U) << resourceUsage;
+    EXPECT_EQ(resourceUsage.writeSyscalls, 1U) << resourceUsage;
+}
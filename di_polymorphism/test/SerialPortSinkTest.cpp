@@ -0,0 +1,78 @@
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "CameraPowerController.h"
+#include "MockSerialPortAdapter.h"
+#include "SerialPortSink.h"
+
+using namespace std::literals;
+
+namespace
+{
+struct RecordingSerialPort
+{
+    void write(SerialMessage message)
+    {
+        written.emplace_back(message.view());
+    }
+
+    std::vector<std::string> written;
+};
+
+struct FinalRecordingSerialPortAdapter final : public SerialPortAdapter
+{
+    void send(SerialMessage message) override
+    {
+        sent.emplace_back(message.view());
+    }
+
+    std::vector<std::string> sent;
+};
+} // namespace
+
+TEST(SerialPortSinkTest, send_WhenMadeFromInterface_WillCallImplementation)
+{
+    MockSerialPortAdapter serialPortAdapter;
+    SerialPortAdapter* serialPortAdapterInterface = &serialPortAdapter;
+    const SerialPortSink serialPortSink{serialPortAdapterInterface};
+
+    EXPECT_CALL(serialPortAdapter, send("ON"sv));
+    serialPortSink.send("ON");
+}
+
+TEST(SerialPortSinkTest, send_WhenMadeFromFinalClass_WillCallIt)
+{
+    FinalRecordingSerialPortAdapter serialPortAdapter;
+    const SerialPortSink serialPortSink{&serialPortAdapter};
+
+    serialPortSink.send("ON");
+
+    EXPECT_THAT(serialPortAdapter.sent, ::testing::ElementsAre("ON"));
+}
+
+TEST(SerialPortSinkTest, send_WhenBoundToMemberFunction_WillCallIt)
+{
+    RecordingSerialPort serialPort;
+    const auto serialPortSink
+        = SerialPortSink::bind<&RecordingSerialPort::write>(&serialPort);
+
+    serialPortSink.send("OFF");
+
+    EXPECT_THAT(serialPort.written, ::testing::ElementsAre("OFF"));
+}
+
+TEST(SerialPortSinkTest,
+     cameraPowerController_WhenGivenBoundSink_WillSendCommandsThroughIt)
+{
+    RecordingSerialPort serialPort;
+    CameraPowerController cameraPowerController{
+        SerialPortSink::bind<&RecordingSerialPort::write>(&serialPort)};
+
+    cameraPowerController.turnOnCamera();
+    cameraPowerController.turnOffCamera();
+
+    EXPECT_THAT(serialPort.written, ::testing::ElementsAre("ON", "OFF"));
+}
@@ -7,7 +7,13 @@
 class MockSerialPortAdapter : public SerialPortAdapter
 {
 public:
-    MOCK_METHOD(void, send, (std::string_view message), (override));
+    MOCK_METHOD(void, send, (std::string_view message), ());
+
+    // Expectations are set on the payload rather than on the message type
+    void send(SerialMessage message) override
+    {
+        send(message.view());
+    }
 };
 
 #endif // BREAKTHEDEPENDENCY_MOCKSERIALPORTADAPTER_H
@@ -0,0 +1,30 @@
+#ifndef BREAKTHEDEPENDENCY_RECORDINGSERIALPORTADAPTER_H
+#define BREAKTHEDEPENDENCY_RECORDINGSERIALPORTADAPTER_H
+
+#include <utility>
+
+#include "RecordingLog.h"
+#include "SerialPortAdapter.h"
+
+/// Records every message instead of sending it, from as many threads at once
+/// as there are, for load tests where a mock would be the bottleneck. Final,
+/// so that a SerialPortSink referring to it records without a virtual call.
+class RecordingSerialPortAdapter final : public SerialPortAdapter
+{
+public:
+    /// The log has to outlive the adapter
+    explicit RecordingSerialPortAdapter(RecordingLog* recordingLog)
+        : mRecordingLog{recordingLog}
+    {
+    }
+
+    void send(SerialMessage message) override
+    {
+        mRecordingLog->record(std::move(message));
+    }
+
+private:
+    RecordingLog* mRecordingLog;
+};
+
+#endif // BREAKTHEDEPENDENCY_RECORDINGSERIALPORTADAPTER_H
@@ -0,0 +1,41 @@
+#include "gtest/gtest.h"
+
+#include "CameraPowerController.h"
+#include "PosixSerialPortManager.h"
+#include "ResourceUsageFixture.h"
+#include "SimulatedSerialDevice.h"
+
+struct DiTemplateResourceUsageTest : public ResourceUsageFixture
+{
+    DiTemplateResourceUsageTest()
+    {
+        // Opens the port, which is not what is measured
+        mCameraPowerController.turnOffCamera();
+    }
+
+    SimulatedSerialDevice mSimulatedSerialDevice;
+    PosixSerialPortManager mPosixSerialPortManager{
+        mSimulatedSerialDevice.serialDevice().native(), 9600};
+    CameraPowerController<PosixSerialPortManager> mCameraPowerController{
+        &mPosixSerialPortManager};
+};
+
+TEST_F(DiTemplateResourceUsageTest,
+       turnOnCamera_WhenPortOpen_WillNotAllocateAndWriteOnce)
+{
+    const auto resourceUsage
+        = measure([this] { mCameraPowerController.turnOnCamera(); });
+
+    EXPECT_EQ(resourceUsage.allocations, 0U) << resourceUsage;
+    EXPECT_EQ(resourceUsage.writeSyscalls, 1U) << resourceUsage;
+}
+
+TEST_F(DiTemplateResourceUsageTest,
+       turnOffCamera_WhenPortOpen_WillNotAllocateAndWriteOnce)
+{
+    const auto resourceUsage
+        = measure([this] { mCameraPowerController.turnOffCamera(); });
+
+    EXPECT_EQ(resourceUsage.allocations, 0U) << resourceUsage;
+    EXPECT_EQ(resourceUsage.writeSyscalls, 1U) << resourceUsage;
+}
@@ -1,31 +1,11 @@
-#include <stdexcept>
-
 #include "CameraPowerController.h"
-
-namespace
-{
-const std::filesystem::path kSerialDevicePathForVariantA{
-    "/dev/CoolCompanyDevice"};
-const auto kBaudRateForVariantA = 9600;
-const std::filesystem::path kSerialDevicePathForVariantB{"COM3"};
-const auto kBaudRateForVariantB = 115200;
-} // namespace
+#include "ProductVariantTraits.h"
 
 CameraPowerController::CameraPowerController(ProductVariant productVariant)
 {
-    switch (productVariant)
-    {
-    case ProductVariant::A:
-        mAsioSerialPortManager = std::make_unique<AsioSerialPortManager>(
-            kSerialDevicePathForVariantA, kBaudRateForVariantA);
-        return;
-    case ProductVariant::B:
-        mAsioSerialPortManager = std::make_unique<AsioSerialPortManager>(
-            kSerialDevicePathForVariantB, kBaudRateForVariantB);
-        return;
-    default:
-        throw std::logic_error("Unknown variant");
-    }
+    const auto& traits = getProductVariantTraits(productVariant);
+    mAsioSerialPortManager = std::make_unique<AsioSerialPortManager>(
+        traits.serialDevice, traits.baudRate);
 }
 
 void CameraPowerController::turnOnCamera()
@@ -0,0 +1,50 @@
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "CameraPowerController.h"
+#include "RecordingSerialPorts.h"
+
+namespace
+{
+constexpr std::size_t kThreads           = 4;
+constexpr std::size_t kCommandsPerThread = 10000;
+} // namespace
+
+struct LinkSwitchConcurrencyTest : public ::testing::Test
+{
+    ~LinkSwitchConcurrencyTest() override
+    {
+        RecordingSerialPorts::clear();
+    }
+
+    RecordingLog& mRecordingLog{
+        RecordingSerialPorts::of("/dev/CoolCompanyDevice")};
+};
+
+TEST_F(LinkSwitchConcurrencyTest,
+       turnOnCamera_WhenControllersOfSamePortUsedByManyThreads_WillSendAll)
+{
+    std::vector<std::thread> producers;
+    for (std::size_t i = 0; i < kThreads; ++i)
+    {
+        producers.emplace_back([] {
+            CameraPowerController cameraPowerController{ProductVariant::A};
+            for (std::size_t command = 0; command < kCommandsPerThread;
+                 ++command)
+            {
+                cameraPowerController.turnOnCamera();
+                cameraPowerController.turnOffCamera();
+            }
+        });
+    }
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+
+    EXPECT_EQ(mRecordingLog.count("ON"), kThreads * kCommandsPerThread);
+    EXPECT_EQ(mRecordingLog.count("OFF"), kThreads * kCommandsPerThread);
+}
@@ -0,0 +1,87 @@
+#include <cstdarg>
+#include <filesystem>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "CameraPowerController.h"
+#include "ProductVariantTraits.h"
+#include "ResourceUsageFixture.h"
+#include "SimulatedSerialDevice.h"
+
+namespace
+{
+/// Opened in place of the device of the product variant, which the
+/// controller picks on its own
+std::filesystem::path gSimulatedSerialDevice;
+} // namespace
+
+// Being defined in the executable, this takes the place of the libc wrapper
+// for the controller's manager, the same way the resource tracking counts the
+// syscalls. Every other path is opened as it is.
+extern "C" int open(const char* path, int flags, ...)
+{
+    mode_t mode = 0;
+    if ((flags & (O_CREAT | O_TMPFILE)) != 0)
+    {
+        va_list arguments;
+        va_start(arguments, flags);
+        mode = static_cast<mode_t>(va_arg(arguments, int));
+        va_end(arguments);
+    }
+    if (!gSimulatedSerialDevice.empty()
+        && path == getProductVariantTraits(ProductVariant::A).serialDevice)
+    {
+        path = gSimulatedSerialDevice.c_str();
+    }
+
+    return static_cast<int>(
+        ::syscall(SYS_openat, AT_FDCWD, path, flags, mode));
+}
+
+struct LinkSwitchResourceUsageTest : public ResourceUsageFixture
+{
+    LinkSwitchResourceUsageTest()
+    {
+        gSimulatedSerialDevice = mSimulatedSerialDevice.serialDevice();
+        // Opens the port, which is not what is measured
+        mCameraPowerController.turnOffCamera();
+    }
+
+    ~LinkSwitchResourceUsageTest() override
+    {
+        gSimulatedSerialDevice.clear();
+    }
+
+    SimulatedSerialDevice mSimulatedSerialDevice;
+    CameraPowerController mCameraPowerController{ProductVariant::A};
+};
+
+TEST_F(LinkSwitchResourceUsageTest,
+       turnOnCamera_WhenPortOpen_WillExceedTheBudgetByTheManagersWrite)
+{
+    const auto resourceUsage
+        = measure([this] { mCameraPowerController.turnOnCamera(); });
+
+    // Over the budget of no allocations and a single write, by what the
+    // blocking asioWrite() of the manager costs on its own: five allocations
+    // and the reactor's two syscalls waiting for the write
+    EXPECT_EQ(resourceUsage.allocations, 5U) << resourceUsage;
+    EXPECT_EQ(resourceUsage.syscalls, 3U) << resourceUsage;
+    EXPECT_EQ(resourceUsage.writeSyscalls, 1U) << resourceUsage;
+}
+
+TEST_F(LinkSwitchResourceUsageTest,
+       turnOffCamera_WhenPortOpen_WillExceedTheBudgetByTheManagersWrite)
+{
+    const auto resourceUsage
+        = measure([this] { mCameraPowerController.turnOffCamera(); });
+
+    EXPECT_EQ(resourceUsage.allocations, 5U) << resourceUsage;
+    EXPECT_EQ(resourceUsage.syscalls, 3U) << resourceUsage;
+    EXPECT_EQ(resourceUsage.writeSyscalls, 1U) << resourceUsage;
+}
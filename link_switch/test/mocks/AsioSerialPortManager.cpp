@@ -1,6 +1,10 @@
 #include "AsioSerialPortManager.h"
 #include "MockAsioSerialPortManager.h"
 
+struct AsioSerialPortManager::Impl
+{
+};
+
 AsioSerialPortManager::AsioSerialPortManager(std::filesystem::path serialDevice,
                                              int baudRate)
 {
@@ -8,7 +12,14 @@ AsioSerialPortManager::AsioSerialPortManager(std::filesystem::path serialDevice,
                                                                    baudRate);
 }
 
-void AsioSerialPortManager::asioWrite(std::string_view message)
+AsioSerialPortManager::~AsioSerialPortManager() = default;
+
+void AsioSerialPortManager::asioWrite(SerialMessage message)
+{
+    MockAsioSerialPortManager::getInstance().asioWrite(message.view());
+}
+
+std::future<void> AsioSerialPortManager::warmUp()
 {
-    MockAsioSerialPortManager::getInstance().asioWrite(message);
+    return MockAsioSerialPortManager::getInstance().warmUp();
 }
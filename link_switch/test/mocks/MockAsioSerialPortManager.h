@@ -3,11 +3,13 @@
 
 #include "gmock/gmock.h"
 #include <filesystem>
+#include <future>
 #include <string_view>
 
 struct MockAsioSerialPortManager
 {
     MOCK_METHOD(void, asioWrite, (std::string_view message), ());
+    MOCK_METHOD(std::future<void>, warmUp, (), ());
     MOCK_METHOD(void,
                 AsioSerialPortManager,
                 (std::filesystem::path serialDevice, int baudRate),
@@ -0,0 +1,36 @@
+#include <memory>
+#include <utility>
+
+#include "AsioSerialPortManager.h"
+#include "RecordingSerialPorts.h"
+
+// Records to RecordingSerialPorts::of() the device each manager is constructed
+// with, from as many threads at once as there are, instead of writing to it
+
+struct AsioSerialPortManager::Impl
+{
+    RecordingLog& recordingLog;
+};
+
+AsioSerialPortManager::AsioSerialPortManager(std::filesystem::path serialDevice,
+                                             int)
+    // Creates the log up front, so that writing never has to look it up
+    : mImpl{std::make_unique<Impl>(
+        RecordingSerialPorts::of(serialDevice.native()))}
+{
+}
+
+AsioSerialPortManager::~AsioSerialPortManager() = default;
+
+void AsioSerialPortManager::asioWrite(SerialMessage message)
+{
+    mImpl->recordingLog.record(std::move(message));
+}
+
+std::future<void> AsioSerialPortManager::warmUp()
+{
+    std::promise<void> opened;
+    opened.set_value();
+
+    return opened.get_future();
+}
@@ -2,49 +2,94 @@
 
 #include <memory>
 #include <filesystem>
+#include <future>
+#include <string_view>
+#include <type_traits>
 
 #include "ProductVariant.h"
+#include "ProductVariantTraits.h"
 
-template<typename SerialPortManager>
+/// Where a CameraPowerController keeps its SerialPortManager
+enum class ManagerStorage
+{
+    /// Allocated on its own, constructed with the device as a
+    /// std::filesystem::path
+    Heap,
+    /// Part of the controller, constructed with the device as a
+    /// std::string_view pointing into the variant's traits. With a manager
+    /// that does not allocate either, e.g. PosixSerialPortManager, the
+    /// controller can live in static storage or an arena without ever
+    /// touching the heap.
+    InPlace
+};
+
+template<typename SerialPortManager,
+         ManagerStorage managerStorage = ManagerStorage::Heap>
 class CameraPowerController
 {
 public:
     CameraPowerController(ProductVariant productVariant)
+        : mSerialPortManager{
+            makeSerialPortManager(getProductVariantTraits(productVariant))}
     {
-        switch (productVariant)
-        {
-        case ProductVariant::A:
-        {
-            const std::filesystem::path kSerialDevicePathForVariantA{
-                "/dev/CoolCompanyDevice"};
-            const auto kBaudRateForVariantA = 9600;
-            mSerialPortManager = std::make_unique<SerialPortManager>(
-                kSerialDevicePathForVariantA, kBaudRateForVariantA);
-        }
-            return;
-        case ProductVariant::B:
-        {
-            const std::filesystem::path kSerialDevicePathForVariantB{"COM3"};
-            const auto kBaudRateForVariantB = 115200;
-            mSerialPortManager = std::make_unique<SerialPortManager>(
-                kSerialDevicePathForVariantB, kBaudRateForVariantB);
-        }
-            return;
-        default:
-            throw std::logic_error("Unknown variant");
-        }
+    }
+
+    /// For a variant known at compile time, e.g.
+    /// `CameraPowerController<AsioSerialPortManager>{kProductVariant<ProductVariant::A>}`,
+    /// the device and baud rate are constants and nothing is looked up
+    template<ProductVariant productVariant>
+    CameraPowerController(ProductVariantConstant<productVariant>)
+        : mSerialPortManager{
+            makeSerialPortManager(kProductVariantTraitsFor<productVariant>)}
+    {
+    }
+
+    /// Opens the serial port without waiting for the first command, the
+    /// SerialPortManager is expected to defer it until then otherwise
+    std::future<void> warmUp()
+    {
+        return serialPortManager().warmUp();
     }
 
     void turnOnCamera()
     {
-        mSerialPortManager->asioWrite("ON");
+        serialPortManager().asioWrite("ON");
     }
 
     void turnOffCamera()
     {
-        mSerialPortManager->asioWrite("OFF");
+        serialPortManager().asioWrite("OFF");
     }
 
 private:
-    std::unique_ptr<SerialPortManager> mSerialPortManager;
+    using Storage = std::conditional_t<managerStorage == ManagerStorage::InPlace,
+                                       SerialPortManager,
+                                       std::unique_ptr<SerialPortManager>>;
+
+    static Storage makeSerialPortManager(const ProductVariantTraits& traits)
+    {
+        if constexpr (managerStorage == ManagerStorage::InPlace)
+        {
+            return SerialPortManager{traits.serialDevice, traits.baudRate};
+        }
+        else
+        {
+            return std::make_unique<SerialPortManager>(
+                std::filesystem::path{traits.serialDevice}, traits.baudRate);
+        }
+    }
+
+    SerialPortManager& serialPortManager()
+    {
+        if constexpr (managerStorage == ManagerStorage::InPlace)
+        {
+            return mSerialPortManager;
+        }
+        else
+        {
+            return *mSerialPortManager;
+        }
+    }
+
+    Storage mSerialPortManager;
 };
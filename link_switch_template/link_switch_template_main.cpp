@@ -1,23 +1,21 @@
 #include "AsioSerialPortManager.h"
 #include "CameraPowerController.h"
 #include "ProductVariant.h"
+#include "ProductVariantTraits.h"
 
 namespace
 {
-ProductVariant getProductVariant()
-{
 #if __linux__
-    return ProductVariant::A;
+constexpr auto kTargetProductVariant = ProductVariant::A;
 #else
-    return ProductVariant::B;
+constexpr auto kTargetProductVariant = ProductVariant::B;
 #endif
-}
 } // namespace
 
 int main()
 {
     CameraPowerController<AsioSerialPortManager> cameraPowerController{
-        getProductVariant()};
+        kProductVariant<kTargetProductVariant>};
     cameraPowerController.turnOnCamera();
     cameraPowerController.turnOffCamera();
 
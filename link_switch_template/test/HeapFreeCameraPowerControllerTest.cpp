@@ -0,0 +1,99 @@
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string_view>
+
+#include "gtest/gtest.h"
+
+#include "CameraPowerController.h"
+#include "HeapGuard.h"
+#include "PosixSerialPortManager.h"
+
+using namespace std::literals;
+
+namespace
+{
+/// Keeps what it is given in fixed storage instead of writing it anywhere
+class RecordingSerialPortManager
+{
+public:
+    RecordingSerialPortManager(std::string_view serialDevice, int baudRate)
+        : mSerialDevice{serialDevice}
+        , mBaudRate{baudRate}
+    {
+    }
+
+    RecordingSerialPortManager(const RecordingSerialPortManager&) = delete;
+    RecordingSerialPortManager&
+    operator=(const RecordingSerialPortManager&) = delete;
+
+    void asioWrite(SerialMessage message)
+    {
+        mMessages.at(mMessageCount++) = message.view();
+    }
+
+    std::string_view mSerialDevice;
+    int mBaudRate;
+    std::array<std::string_view, 8> mMessages{};
+    std::size_t mMessageCount{0};
+};
+
+/// Caller provided storage, as it would be reserved on a target without heap
+template<typename T>
+struct StaticStorage
+{
+    template<typename... Arguments>
+    T* construct(Arguments&&... arguments)
+    {
+        return new (mBytes.data()) T{std::forward<Arguments>(arguments)...};
+    }
+
+    alignas(T) std::array<std::byte, sizeof(T)> mBytes;
+};
+} // namespace
+
+TEST(HeapFreeCameraPowerControllerTest,
+     turnOnCamera_WhenManagerInPlace_WillNotAllocateFromConstructionOn)
+{
+    using Controller = CameraPowerController<RecordingSerialPortManager,
+                                             ManagerStorage::InPlace>;
+    StaticStorage<Controller> storage;
+    {
+        HeapGuard heapGuard;
+        auto* cameraPowerController = storage.construct(ProductVariant::A);
+        cameraPowerController->turnOnCamera();
+        cameraPowerController->turnOffCamera();
+        std::destroy_at(cameraPowerController);
+    }
+
+    EXPECT_EQ(HeapGuard::refusedAllocations(), 0U);
+}
+
+TEST(HeapFreeCameraPowerControllerTest,
+     turnOnCamera_WhenVariantKnownAtCompileTime_WillNotAllocate)
+{
+    {
+        HeapGuard heapGuard;
+        CameraPowerController<RecordingSerialPortManager,
+                              ManagerStorage::InPlace>
+            cameraPowerController{kProductVariant<ProductVariant::B>};
+        cameraPowerController.turnOnCamera();
+    }
+
+    EXPECT_EQ(HeapGuard::refusedAllocations(), 0U);
+}
+
+TEST(HeapFreeCameraPowerControllerTest,
+     constructor_WhenPosixManagerInPlace_WillNotAllocate)
+{
+    using Controller = CameraPowerController<PosixSerialPortManager,
+                                             ManagerStorage::InPlace>;
+    StaticStorage<Controller> storage;
+    {
+        HeapGuard heapGuard;
+        std::destroy_at(storage.construct(ProductVariant::A));
+    }
+
+    EXPECT_EQ(HeapGuard::refusedAllocations(), 0U);
+}
@@ -45,6 +45,26 @@ TEST_F(CameraPowerControllerConstructorTest,
         ProductVariant::B};
 }
 
+TEST_F(CameraPowerControllerConstructorTest,
+       constructor_WhenProductVariantAKnownAtCompileTime_WillInitializeCorrectSerial)
+{
+    EXPECT_CALL(mAsioSerialPortManager,
+                AsioSerialPortManager(kSerialDevicePathForVariantA,
+                                      kBaudRateForVariantA));
+    CameraPowerController<AsioSerialPortManager> mCameraPowerController{
+        kProductVariant<ProductVariant::A>};
+}
+
+TEST_F(CameraPowerControllerConstructorTest,
+       constructor_WhenProductVariantBKnownAtCompileTime_WillInitializeCorrectSerial)
+{
+    EXPECT_CALL(mAsioSerialPortManager,
+                AsioSerialPortManager(kSerialDevicePathForVariantB,
+                                      kBaudRateForVariantB));
+    CameraPowerController<AsioSerialPortManager> mCameraPowerController{
+        kProductVariant<ProductVariant::B>};
+}
+
 TEST_F(CameraPowerControllerConstructorTest,
        constructor_WhenInvalidProductVariant_WillCrash)
 {
@@ -84,3 +104,9 @@ TEST_F(CameraPowerControllerTest,
     EXPECT_CALL(mAsioSerialPortManager, asioWrite("OFF"sv));
     mCameraPowerController->turnOffCamera();
 }
+
+TEST_F(CameraPowerControllerTest, warmUp_WhenCalled_WillWarmUpSerialPort)
+{
+    EXPECT_CALL(mAsioSerialPortManager, warmUp());
+    mCameraPowerController->warmUp();
+}
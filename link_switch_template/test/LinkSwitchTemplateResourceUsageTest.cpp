@@ -0,0 +1,65 @@
+#include <filesystem>
+#include <optional>
+
+#include "gtest/gtest.h"
+
+#include "AsioSerialPortManager.h"
+#include "CameraPowerController.h"
+#include "ResourceUsageFixture.h"
+#include "SimulatedSerialDevice.h"
+
+namespace
+{
+/// The device of the simulated serial device, which the controller cannot be
+/// handed since it picks the device of the product variant on its own
+std::filesystem::path gSimulatedSerialDevice;
+
+class RedirectedAsioSerialPortManager : public AsioSerialPortManager
+{
+public:
+    RedirectedAsioSerialPortManager(const std::filesystem::path&, int baudRate)
+        : AsioSerialPortManager{gSimulatedSerialDevice, baudRate}
+    {
+    }
+};
+} // namespace
+
+struct LinkSwitchTemplateResourceUsageTest : public ResourceUsageFixture
+{
+    LinkSwitchTemplateResourceUsageTest()
+    {
+        gSimulatedSerialDevice = mSimulatedSerialDevice.serialDevice();
+        mCameraPowerController.emplace(ProductVariant::A);
+        // Opens the port, which is not what is measured
+        mCameraPowerController->turnOffCamera();
+    }
+
+    SimulatedSerialDevice mSimulatedSerialDevice;
+    std::optional<CameraPowerController<RedirectedAsioSerialPortManager>>
+        mCameraPowerController;
+};
+
+TEST_F(LinkSwitchTemplateResourceUsageTest,
+       turnOnCamera_WhenPortOpen_WillExceedTheBudgetByTheManagersWrite)
+{
+    const auto resourceUsage
+        = measure([this] { mCameraPowerController->turnOnCamera(); });
+
+    // Over the budget of no allocations and a single write, by exactly the
+    // cost of the manager's blocking asioWrite(): five allocations and the
+    // reactor's two syscalls waiting for the write
+    EXPECT_EQ(resourceUsage.allocations, 5U) << resourceUsage;
+    EXPECT_EQ(resourceUsage.syscalls, 3U) << resourceUsage;
+    EXPECT_EQ(resourceUsage.writeSyscalls, 1U) << resourceUsage;
+}
+
+TEST_F(LinkSwitchTemplateResourceUsageTest,
+       turnOffCamera_WhenPortOpen_WillExceedTheBudgetByTheManagersWrite)
+{
+    const auto resourceUsage
+        = measure([this] { mCameraPowerController->turnOffCamera(); });
+
+    EXPECT_EQ(resourceUsage.allocations, 5U) << resourceUsage;
+    EXPECT_EQ(resourceUsage.syscalls, 3U) << resourceUsage;
+    EXPECT_EQ(resourceUsage.writeSyscalls, 1U) << resourceUsage;
+}
@@ -1,18 +1,221 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <string_view>
+#include <system_error>
+#include <utility>
 
 #include "AsioSerialPortManager.h"
 #include "ProductVariant.h"
+#include "WireProtocol.h"
+#include "WriteMetrics.h"
 
 class CameraPowerController
 {
 public:
+    /// Whether a command is sent even though it is the last one that was,
+    /// e.g. after the camera has been power cycled by other means
+    enum class Force
+    {
+        No,
+        Yes
+    };
+
+    /// How long a confirmed command waits for the camera to report back
+    static constexpr std::chrono::steady_clock::duration kConfirmationTimeout
+        = std::chrono::seconds{1};
+
     CameraPowerController(ProductVariant productVariant);
+    /// For a camera of the variant that is attached through another device
+    /// than the variant's usual one, e.g. a USB adapter enumerated differently
+    CameraPowerController(ProductVariant productVariant,
+                          std::filesystem::path serialDevice);
+    /// Commands still waiting for confirmation complete with
+    /// `asio::error::operation_aborted`
+    ~CameraPowerController();
+
+    /// Opens the serial port without waiting for the first command. Warming up
+    /// several controllers opens their ports in parallel.
+    std::future<void> warmUp();
+    /// A command that is the last one sent is skipped unless forced, since
+    /// the camera is either in that state already or about to be. A command
+    /// still waiting to be written is replaced by the next one, unless it
+    /// waits for confirmation, so that toggling the camera faster than the
+    /// port can keep up with only sends the latest state.
+    void turnOnCamera(Force force = Force::No);
+    void turnOffCamera(Force force = Force::No);
+
+    /// Complete through an asio completion token once the command has left
+    /// the serial port, so that power sequences can be written as coroutines
+    /// running on the caller's own I/O context, e.g.
+    /// `co_await cameraPowerController.turnOnCamera(asio::use_awaitable);`
+    /// Skipped commands complete right away.
+    template<typename CompletionToken>
+    auto turnOnCamera(CompletionToken&& token, Force force = Force::No)
+    {
+        return asyncSend(
+            PowerState::On, force, std::forward<CompletionToken>(token));
+    }
 
-    void turnOnCamera();
-    void turnOffCamera();
+    template<typename CompletionToken>
+    auto turnOffCamera(CompletionToken&& token, Force force = Force::No)
+    {
+        return asyncSend(
+            PowerState::Off, force, std::forward<CompletionToken>(token));
+    }
+
+    /// Like the above but complete once the camera has reported back the state
+    /// it was switched to, rather than once the command has been sent, e.g.
+    /// `co_await cameraPowerController.turnOnCameraConfirmed(asio::use_awaitable);`
+    /// Reports arrive as frames terminated by a newline, e.g. "ON\n", and are
+    /// matched to the oldest command waiting for the same state that has
+    /// already left the serial port, so that a report that was on its way
+    /// before cannot confirm it. These commands are never skipped, only the
+    /// camera can confirm its state, nor replaced by a later command. They
+    /// complete with `asio::error::timed_out` if no report arrives within
+    /// `timeout` and with the error of the write if it fails.
+    template<typename CompletionToken>
+    auto turnOnCameraConfirmed(
+        CompletionToken&& token,
+        std::chrono::steady_clock::duration timeout = kConfirmationTimeout)
+    {
+        return asyncSendConfirmed(
+            PowerState::On, timeout, std::forward<CompletionToken>(token));
+    }
+
+    template<typename CompletionToken>
+    auto turnOffCameraConfirmed(
+        CompletionToken&& token,
+        std::chrono::steady_clock::duration timeout = kConfirmationTimeout)
+    {
+        return asyncSendConfirmed(
+            PowerState::Off, timeout, std::forward<CompletionToken>(token));
+    }
+
+    /// Counts the commands sent by whether they were written, failed, were
+    /// superseded or were turned away by a full queue, and records how long
+    /// the written ones took from being issued until they had left the serial
+    /// port. Skipped commands are only counted by skippedCommands().
+    WriteMetricsSnapshot metrics() const;
+    /// Commands skipped for being the last one sent
+    std::uint64_t skippedCommands() const;
 
 private:
+    enum class PowerState
+    {
+        Unknown,
+        On,
+        Off
+    };
+
+    enum class Delivery
+    {
+        /// Replaced by the next command while still waiting to be written
+        Coalesced,
+        /// Always written, since its caller waits for the camera's report
+        Confirmed
+    };
+
+    /// Encoded as the variant's WireProtocol
+    SerialMessage commandFor(PowerState powerState) const;
+    /// The camera reports its state as a line of ASCII in either protocol
+    static SerialMessage reportFor(PowerState powerState);
+
+    AsioSerialPortManager& startedAsioSerialPortManager();
+    /// Queues the command unless it is the last one sent and not forced.
+    /// Returns false if it was skipped.
+    bool sendIfNeeded(PowerState powerState,
+                      Force force,
+                      AsioSerialPortManager::WriteHandler onSent = {},
+                      Delivery delivery = Delivery::Coalesced);
+    /// Records the state as the last one sent, unless it already is. Only
+    /// called with mSendMutex held.
+    bool isNeeded(PowerState powerState, Force force);
+    void send(PowerState powerState,
+              AsioSerialPortManager::WriteHandler onSent,
+              Delivery delivery);
+    void onWritten(WriteMetrics::Timestamp issuedAt,
+                   std::error_code error,
+                   std::size_t bytesWritten);
+
+    template<typename CompletionToken>
+    auto asyncSend(PowerState powerState, Force force, CompletionToken&& token)
+    {
+        return asio::async_initiate<CompletionToken, void(std::error_code)>(
+            [this, powerState, force](auto handler) {
+                auto onCompleted = postToAssociatedExecutor(std::move(handler));
+                const auto sent = sendIfNeeded(
+                    powerState,
+                    force,
+                    [onCompleted](std::error_code error,
+                                  std::size_t) mutable { onCompleted(error); });
+                if (!sent)
+                {
+                    onCompleted(std::error_code{});
+                }
+            },
+            token);
+    }
+
+    template<typename CompletionToken>
+    auto asyncSendConfirmed(PowerState powerState,
+                            std::chrono::steady_clock::duration timeout,
+                            CompletionToken&& token)
+    {
+        return asio::async_initiate<CompletionToken, void(std::error_code)>(
+            [this, powerState, timeout](auto handler) {
+                sendConfirmed(powerState,
+                              timeout,
+                              postToAssociatedExecutor(std::move(handler)));
+            },
+            token);
+    }
+
+    using ConfirmationHandler = std::function<void(std::error_code error)>;
+
+    struct PendingConfirmation
+    {
+        std::uint64_t id;
+        SerialMessage state;
+        /// Only reports received after the command was written confirm it
+        bool sent{false};
+        // Kept at a stable address for the wait pending on it
+        std::unique_ptr<asio::steady_timer> deadline;
+        ConfirmationHandler onConfirmed;
+    };
+
+    void sendConfirmed(PowerState powerState,
+                       std::chrono::steady_clock::duration timeout,
+                       ConfirmationHandler onConfirmed);
+    void markSent(std::uint64_t id);
+    void confirm(std::string_view reportedState);
+    ConfirmationHandler takePendingConfirmation(std::uint64_t id);
+
+    WireProtocol mWireProtocol;
+    std::uint8_t mBusAddress;
+    std::mutex mPendingConfirmationsMutex;
+    std::deque<PendingConfirmation> mPendingConfirmations;
+    std::uint64_t mNextConfirmationId{0};
+    // Makes recording the last state sent and queueing its command one step,
+    // so that the last command queued is always the state recorded
+    std::mutex mSendMutex;
+    // Moved on past every confirmed command, so that the commands after it
+    // cannot replace one queued before it and overtake it
+    AsioSerialPortManager::CoalescingKey mPowerCommandKey{0};
+    // Also reset to Unknown by failed writes, without the mutex
+    std::atomic<PowerState> mPowerState{PowerState::Unknown};
+    std::atomic<std::uint64_t> mSkippedCommands{0};
+    // Outlives the manager, whose destruction completes the queued commands
+    [[no_unique_address]] WriteMetrics mWriteMetrics;
     std::unique_ptr<AsioSerialPortManager> mAsioSerialPortManager;
+    std::once_flag mAsioSerialPortManagerStarted;
 };
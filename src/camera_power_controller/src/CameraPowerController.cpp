@@ -1,39 +1,308 @@
-#include <stdexcept>
+#include <algorithm>
+#include <utility>
 
+#include "CameraCommand.h"
 #include "CameraPowerController.h"
+#include "FrameParser.h"
+#include "ProductVariantTraits.h"
 
 namespace
 {
-const std::filesystem::path kSerialDevicePathForVariantA{
-    "/dev/CoolCompanyDevice"};
-const auto kBaudRateForVariantA = 9600;
-const std::filesystem::path kSerialDevicePathForVariantB{"COM3"};
-const auto kBaudRateForVariantB = 115200;
+constexpr auto kStateReportDelimiter = '\n';
+// Longer frames are telemetry that no command waits for
+constexpr std::size_t kMaxStateReportSize = 16;
 } // namespace
 
 CameraPowerController::CameraPowerController(ProductVariant productVariant)
+    : CameraPowerController{
+        productVariant, getProductVariantTraits(productVariant).serialDevice}
 {
-    switch (productVariant)
+}
+
+CameraPowerController::CameraPowerController(ProductVariant productVariant,
+                                             std::filesystem::path serialDevice)
+{
+    const auto& traits = getProductVariantTraits(productVariant);
+    mWireProtocol      = traits.wireProtocol;
+    mBusAddress        = traits.busAddress;
+
+    mAsioSerialPortManager = std::make_unique<AsioSerialPortManager>(
+        std::move(serialDevice), traits.baudRate);
+    mAsioSerialPortManager->setFrameHandler(
+        FrameParser::delimited(kStateReportDelimiter, kMaxStateReportSize),
+        [this](std::string_view reportedState) { confirm(reportedState); });
+}
+
+CameraPowerController::~CameraPowerController()
+{
+    decltype(mPendingConfirmations) pendingConfirmations;
+    {
+        std::lock_guard lock{mPendingConfirmationsMutex};
+        pendingConfirmations = std::exchange(mPendingConfirmations, {});
+    }
+    // Stopping the manager waits for the deadlines, which have to go before
+    // its I/O context does anyway
+    for (auto& pendingConfirmation : pendingConfirmations)
+    {
+        pendingConfirmation.deadline->cancel();
+    }
+    // Nothing can be confirmed anymore once the manager has stopped
+    mAsioSerialPortManager->stop();
+    for (auto& pendingConfirmation : pendingConfirmations)
+    {
+        pendingConfirmation.onConfirmed(asio::error::operation_aborted);
+    }
+}
+
+std::future<void> CameraPowerController::warmUp()
+{
+    return startedAsioSerialPortManager().warmUp();
+}
+
+void CameraPowerController::turnOnCamera(Force force)
+{
+    sendIfNeeded(PowerState::On, force);
+}
+
+void CameraPowerController::turnOffCamera(Force force)
+{
+    sendIfNeeded(PowerState::Off, force);
+}
+
+WriteMetricsSnapshot CameraPowerController::metrics() const
+{
+    return mWriteMetrics.snapshot();
+}
+
+std::uint64_t CameraPowerController::skippedCommands() const
+{
+    return mSkippedCommands.load();
+}
+
+SerialMessage CameraPowerController::commandFor(PowerState powerState) const
+{
+    return encodeCameraCommand(mWireProtocol,
+                               powerState == PowerState::On
+                                   ? CameraCommand::TurnOn
+                                   : CameraCommand::TurnOff,
+                               mBusAddress);
+}
+
+SerialMessage CameraPowerController::reportFor(PowerState powerState)
+{
+    return powerState == PowerState::On ? SerialMessage{"ON"}
+                                        : SerialMessage{"OFF"};
+}
+
+AsioSerialPortManager& CameraPowerController::startedAsioSerialPortManager()
+{
+    // Commands are only enqueued by the callers, the UART transmission happens
+    // on the manager's own I/O thread. It is only started once the controller
+    // is used, so that controllers that never are cost neither a thread nor
+    // an open port.
+    std::call_once(mAsioSerialPortManagerStarted,
+                   [this] { mAsioSerialPortManager->start(); });
+
+    return *mAsioSerialPortManager;
+}
+
+bool CameraPowerController::sendIfNeeded(
+    PowerState powerState,
+    Force force,
+    AsioSerialPortManager::WriteHandler onSent,
+    Delivery delivery)
+{
+    // Otherwise a concurrent command could be recorded in between and be
+    // queued before this one, leaving the camera in the other state than
+    // the recorded one
+    std::lock_guard lock{mSendMutex};
+    if (!isNeeded(powerState, force))
+    {
+        return false;
+    }
+
+    send(powerState, std::move(onSent), delivery);
+    return true;
+}
+
+bool CameraPowerController::isNeeded(PowerState powerState, Force force)
+{
+    if (mPowerState.exchange(powerState) == powerState && force == Force::No)
+    {
+        ++mSkippedCommands;
+        return false;
+    }
+
+    return true;
+}
+
+void CameraPowerController::send(PowerState powerState,
+                                 AsioSerialPortManager::WriteHandler onSent,
+                                 Delivery delivery)
+{
+    auto& asioSerialPortManager = startedAsioSerialPortManager();
+    // Small enough for the handler not to allocate, unless the caller waits
+    // for the command to be sent
+    const auto issuedAt = WriteMetrics::now();
+    AsioSerialPortManager::WriteHandler onCompleted;
+    if (onSent)
+    {
+        onCompleted = [this, issuedAt, onSent](std::error_code error,
+                                               std::size_t bytesWritten) {
+            onWritten(issuedAt, error, bytesWritten);
+            onSent(error, bytesWritten);
+        };
+    }
+    else
+    {
+        onCompleted = [this, issuedAt](std::error_code error,
+                                       std::size_t bytesWritten) {
+            onWritten(issuedAt, error, bytesWritten);
+        };
+    }
+
+    auto queued = false;
+    if (delivery == Delivery::Confirmed)
+    {
+        queued = asioSerialPortManager.asyncWrite(commandFor(powerState),
+                                                  std::move(onCompleted));
+        ++mPowerCommandKey;
+    }
+    else
+    {
+        // The controller powers a single camera, so its commands supersede
+        // each other
+        queued = asioSerialPortManager.asyncWriteCoalesced(
+            mPowerCommandKey, commandFor(powerState), std::move(onCompleted));
+    }
+    if (!queued)
+    {
+        mWriteMetrics.recordRejection();
+        mPowerState.store(PowerState::Unknown);
+        if (onSent)
+        {
+            onSent(asio::error::no_buffer_space, 0);
+        }
+    }
+}
+
+void CameraPowerController::onWritten(WriteMetrics::Timestamp issuedAt,
+                                      std::error_code error,
+                                      std::size_t bytesWritten)
+{
+    mWriteMetrics.recordCompletion(issuedAt, error, bytesWritten);
+    // A command replaced by a newer one has been superseded rather than lost,
+    // any other failure leaves the camera in a state nobody knows
+    if (error && error != asio::error::operation_aborted)
+    {
+        mPowerState.store(PowerState::Unknown);
+    }
+}
+
+void CameraPowerController::sendConfirmed(
+    PowerState powerState,
+    std::chrono::steady_clock::duration timeout,
+    ConfirmationHandler onConfirmed)
+{
+    auto& asioSerialPortManager = startedAsioSerialPortManager();
+    std::uint64_t id            = 0;
+    {
+        // Registered before sending so that a quick report cannot be missed
+        std::lock_guard lock{mPendingConfirmationsMutex};
+        id            = mNextConfirmationId++;
+        auto deadline = std::make_unique<asio::steady_timer>(
+            asioSerialPortManager.executor(), timeout);
+        deadline->async_wait([this, id](std::error_code error) {
+            // Cancelled by whoever completed the confirmation first
+            if (error)
+            {
+                return;
+            }
+
+            if (auto onTimedOut = takePendingConfirmation(id))
+            {
+                onTimedOut(asio::error::timed_out);
+            }
+        });
+        mPendingConfirmations.push_back({id,
+                                         reportFor(powerState),
+                                         false,
+                                         std::move(deadline),
+                                         std::move(onConfirmed)});
+    }
+
+    sendIfNeeded(
+        powerState,
+        Force::Yes,
+        [this, id](std::error_code error, std::size_t) {
+            if (!error)
+            {
+                markSent(id);
+                return;
+            }
+
+            if (auto onFailed = takePendingConfirmation(id))
+            {
+                onFailed(error);
+            }
+        },
+        Delivery::Confirmed);
+}
+
+void CameraPowerController::markSent(std::uint64_t id)
+{
+    std::lock_guard lock{mPendingConfirmationsMutex};
+    const auto pendingConfirmation
+        = std::find_if(mPendingConfirmations.begin(),
+                       mPendingConfirmations.end(),
+                       [id](const auto& pending) { return pending.id == id; });
+    if (pendingConfirmation != mPendingConfirmations.end())
     {
-    case ProductVariant::A:
-        mAsioSerialPortManager = std::make_unique<AsioSerialPortManager>(
-            kSerialDevicePathForVariantA, kBaudRateForVariantA);
-        return;
-    case ProductVariant::B:
-        mAsioSerialPortManager = std::make_unique<AsioSerialPortManager>(
-            kSerialDevicePathForVariantB, kBaudRateForVariantB);
-        return;
-    default:
-        throw std::logic_error("Unknown variant");
+        pendingConfirmation->sent = true;
     }
 }
 
-void CameraPowerController::turnOnCamera()
+void CameraPowerController::confirm(std::string_view reportedState)
 {
-    mAsioSerialPortManager->asioWrite("ON");
+    ConfirmationHandler onConfirmed;
+    {
+        std::lock_guard lock{mPendingConfirmationsMutex};
+        // Write completions and reports are handled in the order they happen
+        // on the manager's strand, so a report handled before the command's
+        // write completed was sent before the camera could have seen it
+        const auto pendingConfirmation = std::find_if(
+            mPendingConfirmations.begin(),
+            mPendingConfirmations.end(),
+            [reportedState](const auto& pending) {
+                return pending.sent && pending.state == reportedState;
+            });
+        if (pendingConfirmation == mPendingConfirmations.end())
+        {
+            return;
+        }
+
+        onConfirmed = std::move(pendingConfirmation->onConfirmed);
+        mPendingConfirmations.erase(pendingConfirmation);
+    }
+
+    onConfirmed({});
 }
 
-void CameraPowerController::turnOffCamera()
+CameraPowerController::ConfirmationHandler
+CameraPowerController::takePendingConfirmation(std::uint64_t id)
 {
-    mAsioSerialPortManager->asioWrite("OFF");
+    std::lock_guard lock{mPendingConfirmationsMutex};
+    const auto pendingConfirmation
+        = std::find_if(mPendingConfirmations.begin(),
+                       mPendingConfirmations.end(),
+                       [id](const auto& pending) { return pending.id == id; });
+    if (pendingConfirmation == mPendingConfirmations.end())
+    {
+        return {};
+    }
+
+    auto onConfirmed = std::move(pendingConfirmation->onConfirmed);
+    mPendingConfirmations.erase(pendingConfirmation);
+
+    return onConfirmed;
 }
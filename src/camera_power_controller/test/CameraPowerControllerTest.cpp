@@ -0,0 +1,182 @@
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "CameraCommand.h"
+#include "CameraPowerController.h"
+#include "ProductVariantTraits.h"
+#include "SimulatedSerialDeviceFixture.h"
+
+namespace
+{
+const std::filesystem::path kMissingSerialDevice{"/dev/NoSuchCoolCompanyDevice"};
+
+std::error_code errorOf(std::future<void> completion)
+{
+    try
+    {
+        completion.get();
+    }
+    catch (const std::system_error& error)
+    {
+        return error.code();
+    }
+
+    return {};
+}
+} // namespace
+
+using namespace std::literals;
+using Force = CameraPowerController::Force;
+
+struct CameraPowerControllerTest : public SimulatedSerialDeviceFixture
+{
+    CameraPowerController mCameraPowerController{ProductVariant::A,
+                                                 mSerialDevice};
+};
+
+TEST_F(CameraPowerControllerTest,
+       turnOnCamera_WhenAlreadyTurnedOn_WillSkipTheCommand)
+{
+    mCameraPowerController.turnOnCamera(asio::use_future).get();
+    mCameraPowerController.turnOnCamera(asio::use_future).get();
+    mCameraPowerController.turnOffCamera(asio::use_future).get();
+
+    ASSERT_TRUE(mSimulatedSerialDevice.waitForBytesFromHost(5));
+    EXPECT_EQ(mSimulatedSerialDevice.received(), "ONOFF");
+    EXPECT_EQ(mCameraPowerController.skippedCommands(), 1U);
+}
+
+TEST_F(CameraPowerControllerTest,
+       turnOnCamera_WhenForced_WillSendTheCommandAgain)
+{
+    mCameraPowerController.turnOnCamera(asio::use_future).get();
+    mCameraPowerController.turnOnCamera(asio::use_future, Force::Yes).get();
+
+    ASSERT_TRUE(mSimulatedSerialDevice.waitForBytesFromHost(4));
+    EXPECT_EQ(mSimulatedSerialDevice.received(), "ONON");
+    EXPECT_EQ(mCameraPowerController.skippedCommands(), 0U);
+}
+
+TEST_F(SimulatedSerialDeviceFixture,
+       turnOnCamera_WhenVariantSpeaksCompactBinary_WillSendCompactCommands)
+{
+    CameraPowerController cameraPowerController{ProductVariant::C,
+                                                mSerialDevice};
+
+    cameraPowerController.turnOnCamera(asio::use_future).get();
+    cameraPowerController.turnOffCamera(asio::use_future).get();
+
+    const auto busAddress
+        = getProductVariantTraits(ProductVariant::C).busAddress;
+    const auto turnOn  = encodeCompact(CameraCommand::TurnOn, busAddress);
+    const auto turnOff = encodeCompact(CameraCommand::TurnOff, busAddress);
+    ASSERT_TRUE(mSimulatedSerialDevice.waitForBytesFromHost(
+        2 * kCompactCameraCommandSize));
+    EXPECT_EQ(mSimulatedSerialDevice.received(),
+              std::string(turnOn.begin(), turnOn.end())
+                  + std::string(turnOff.begin(), turnOff.end()));
+}
+
+TEST(CameraPowerControllerOnMissingDeviceTest,
+     turnOnCamera_WhenPreviousCommandFailed_WillSendItAgain)
+{
+    CameraPowerController cameraPowerController{ProductVariant::A,
+                                                kMissingSerialDevice};
+
+    EXPECT_THROW(cameraPowerController.turnOnCamera(asio::use_future).get(),
+                 std::system_error);
+    EXPECT_THROW(cameraPowerController.turnOnCamera(asio::use_future).get(),
+                 std::system_error);
+    EXPECT_EQ(cameraPowerController.skippedCommands(), 0U);
+}
+
+/// Reports back every command it receives as the state it was switched to
+struct ReportingCameraPowerControllerTest : public ::testing::Test
+{
+    SimulatedSerialDevice mSimulatedSerialDevice{
+        {}, [this](std::string_view commands, auto) {
+            // Commands written back to back can arrive in one read
+            while (!commands.empty())
+            {
+                const auto command = commands.substr(
+                    0, commands.starts_with("ON") ? 2 : 3);
+                mSimulatedSerialDevice.sendToHost(std::string{command} + "\n");
+                commands.remove_prefix(command.size());
+            }
+        }};
+    CameraPowerController mCameraPowerController{
+        ProductVariant::A, mSimulatedSerialDevice.serialDevice()};
+};
+
+TEST_F(ReportingCameraPowerControllerTest,
+       turnOnCameraConfirmed_WhenCameraReportsTheState_WillComplete)
+{
+    EXPECT_FALSE(
+        errorOf(mCameraPowerController.turnOnCameraConfirmed(asio::use_future)));
+    EXPECT_FALSE(errorOf(
+        mCameraPowerController.turnOffCameraConfirmed(asio::use_future)));
+}
+
+TEST_F(ReportingCameraPowerControllerTest,
+       turnOnCameraConfirmed_WhenFollowedByTurnOff_WillNotBeReplaced)
+{
+    for (auto toggle = 0; toggle < 10; ++toggle)
+    {
+        auto confirmed
+            = mCameraPowerController.turnOnCameraConfirmed(asio::use_future);
+        mCameraPowerController.turnOffCamera(asio::use_future).get();
+
+        EXPECT_FALSE(errorOf(std::move(confirmed)));
+    }
+
+    ASSERT_TRUE(mSimulatedSerialDevice.waitForBytesFromHost(50));
+    std::string toggles;
+    for (auto toggle = 0; toggle < 10; ++toggle)
+    {
+        toggles += "ONOFF";
+    }
+    EXPECT_EQ(mSimulatedSerialDevice.received(), toggles);
+}
+
+TEST_F(CameraPowerControllerTest,
+       turnOnCameraConfirmed_WhenCameraStaysSilent_WillTimeOut)
+{
+    EXPECT_EQ(errorOf(mCameraPowerController.turnOnCameraConfirmed(
+                  asio::use_future, 50ms)),
+              asio::error::timed_out);
+}
+
+TEST_F(CameraPowerControllerTest,
+       turnOnCameraConfirmed_WhenReportArrivedBeforeTheCommand_WillIgnoreIt)
+{
+    mCameraPowerController.warmUp().get();
+    mSimulatedSerialDevice.sendToHost("ON\n");
+    std::this_thread::sleep_for(50ms);
+
+    EXPECT_EQ(errorOf(mCameraPowerController.turnOnCameraConfirmed(
+                  asio::use_future, 50ms)),
+              asio::error::timed_out);
+}
+
+TEST_F(SimulatedSerialDeviceFixture,
+       destructor_WhenConfirmationPending_WillAbortIt)
+{
+    auto cameraPowerController
+        = std::make_unique<CameraPowerController>(ProductVariant::A,
+                                                  mSerialDevice);
+    auto confirmed
+        = cameraPowerController->turnOnCameraConfirmed(asio::use_future, 10s);
+    ASSERT_TRUE(mSimulatedSerialDevice.waitForBytesFromHost(2));
+
+    cameraPowerController.reset();
+
+    EXPECT_EQ(errorOf(std::move(confirmed)), asio::error::operation_aborted);
+}
@@ -0,0 +1,35 @@
+#include <array>
+
+#include "AsioSerialPortManager.h"
+#include "FleetPowerController.h"
+#include "IoThreadPool.h"
+
+namespace
+{
+const std::filesystem::path kCameraBus{"/dev/CoolCompanyBus"};
+const std::filesystem::path kSerialDevice{"/dev/CoolCompanyDevice"};
+const auto kBaudRate         = 9600;
+const std::size_t kIoThreads = 2;
+} // namespace
+
+int main()
+{
+    // Every port is served by the same few threads, however many there are
+    IoThreadPool ioThreadPool{kIoThreads};
+    FleetPowerController<AsioSerialPortManager> fleetPowerController{
+        [&ioThreadPool](const std::filesystem::path& serialDevice,
+                        int baudRate) {
+            return std::make_unique<AsioSerialPortManager>(
+                ioThreadPool.ioContext(), serialDevice, baudRate);
+        }};
+    fleetPowerController.addCamera(1, kCameraBus, kBaudRate, 1);
+    fleetPowerController.addCamera(2, kCameraBus, kBaudRate, 2);
+    fleetPowerController.addCamera(3, kSerialDevice, kBaudRate);
+
+    const std::array<CameraId, 3> allCameras{1, 2, 3};
+    fleetPowerController.turnOnCameras(allCameras);
+    fleetPowerController.turnOffCameras(allCameras);
+    fleetPowerController.drain();
+
+    return 0;
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "CameraCommand.h"
+#include "SerialMessage.h"
+
+using CameraId = std::uint32_t;
+
+/// Powers many logical cameras that share a handful of serial ports. Every
+/// physical device is opened once, no matter how many cameras are reachable
+/// through it, and cameras daisy-chained on a shared bus are told apart by
+/// their bus address.
+template<typename SerialPortManager>
+class FleetPowerController
+{
+public:
+    using SerialPortManagerFactory
+        = std::function<std::unique_ptr<SerialPortManager>(
+            const std::filesystem::path& serialDevice, int baudRate)>;
+
+    FleetPowerController(
+        SerialPortManagerFactory serialPortManagerFactory =
+            [](const std::filesystem::path& serialDevice, int baudRate) {
+                return std::make_unique<SerialPortManager>(serialDevice,
+                                                           baudRate);
+            })
+        : mSerialPortManagerFactory{std::move(serialPortManagerFactory)}
+    {
+    }
+
+    /// Cameras without a bus address are expected to be alone on their port
+    /// and receive the plain commands, the others receive the commands
+    /// prefixed with their address and ended by a newline, e.g. "3:ON\n", so
+    /// that the commands of a batch stay apart on the bus. Compact binary
+    /// commands always carry an address, which is 0 for cameras without one.
+    void addCamera(CameraId cameraId,
+                   const std::filesystem::path& serialDevice,
+                   int baudRate,
+                   std::optional<std::uint8_t> busAddress = std::nullopt,
+                   WireProtocol wireProtocol              = WireProtocol::Ascii)
+    {
+        auto port = mPorts.find(serialDevice);
+        if (port == mPorts.end())
+        {
+            auto serialPortManager
+                = mSerialPortManagerFactory(serialDevice, baudRate);
+            serialPortManager->start();
+            port = mPorts
+                       .emplace(serialDevice,
+                                Port{std::move(serialPortManager), baudRate})
+                       .first;
+        }
+        else if (port->second.baudRate != baudRate)
+        {
+            throw std::invalid_argument(
+                "Serial device already opened with a different baud rate");
+        }
+
+        // The commands are built once here so that powering a camera never
+        // allocates or copies its payload
+        Camera camera{
+            port->second.serialPortManager.get(),
+            encode(CameraCommand::TurnOn, busAddress, wireProtocol),
+            encode(CameraCommand::TurnOff, busAddress, wireProtocol)};
+        if (!mCameras.emplace(cameraId, std::move(camera)).second)
+        {
+            throw std::invalid_argument("Camera already added");
+        }
+    }
+
+    /// Returns false if the command was not queued, i.e. the queue of the
+    /// camera's port is full and its backpressure policy is
+    /// Backpressure::FailFast
+    bool turnOnCamera(CameraId cameraId)
+    {
+        return send(cameraId, &Camera::turnOnCommand);
+    }
+
+    bool turnOffCamera(CameraId cameraId)
+    {
+        return send(cameraId, &Camera::turnOffCommand);
+    }
+
+    /// Every camera is sent its command even if one of the others was not
+    /// queued, returns false if any of them was not
+    bool turnOnCameras(std::span<const CameraId> cameraIds)
+    {
+        auto allQueued = true;
+        for (const auto cameraId : cameraIds)
+        {
+            allQueued = turnOnCamera(cameraId) && allQueued;
+        }
+
+        return allQueued;
+    }
+
+    bool turnOffCameras(std::span<const CameraId> cameraIds)
+    {
+        auto allQueued = true;
+        for (const auto cameraId : cameraIds)
+        {
+            allQueued = turnOffCamera(cameraId) && allQueued;
+        }
+
+        return allQueued;
+    }
+
+    /// Blocks until the commands sent so far have left every port
+    void drain()
+    {
+        for (auto& [serialDevice, port] : mPorts)
+        {
+            port.serialPortManager->drain();
+        }
+    }
+
+private:
+    struct Port
+    {
+        std::unique_ptr<SerialPortManager> serialPortManager;
+        int baudRate;
+    };
+
+    struct Camera
+    {
+        SerialPortManager* serialPortManager;
+        SerialMessage turnOnCommand;
+        SerialMessage turnOffCommand;
+    };
+
+    static SerialMessage encode(CameraCommand command,
+                                std::optional<std::uint8_t> busAddress,
+                                WireProtocol wireProtocol)
+    {
+        if (wireProtocol == WireProtocol::CompactBinary || !busAddress)
+        {
+            return encodeCameraCommand(
+                wireProtocol, command, busAddress.value_or(0));
+        }
+
+        return SerialMessage::copyOf(
+            std::to_string(*busAddress) + ":"
+            + (command == CameraCommand::TurnOn ? "ON" : "OFF") + "\n");
+    }
+
+    bool send(CameraId cameraId, SerialMessage Camera::*command)
+    {
+        auto& camera = mCameras.at(cameraId);
+        // Keyed by camera so that a burst of toggles for one camera collapses
+        // into its latest state before reaching the wire
+        return camera.serialPortManager->asyncWriteCoalesced(cameraId,
+                                                             camera.*command);
+    }
+
+    SerialPortManagerFactory mSerialPortManagerFactory;
+    std::map<std::filesystem::path, Port> mPorts;
+    std::unordered_map<CameraId, Camera> mCameras;
+};
@@ -0,0 +1,198 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "AsioSerialPortManager.h"
+#include "FleetPowerController.h"
+#include "SimulatedSerialDevice.h"
+
+using namespace std::literals;
+using ::testing::_;
+using ::testing::InSequence;
+using ::testing::Return;
+
+namespace
+{
+const std::filesystem::path kSharedBus{"/dev/CoolCompanyBus"};
+const std::filesystem::path kDedicatedPort{"/dev/CoolCompanyDevice"};
+const auto kBaudRate = 9600;
+} // namespace
+
+class MockSerialPortManager
+{
+public:
+    MOCK_METHOD(void, start, (), ());
+    MOCK_METHOD(void, drain, (), ());
+    MOCK_METHOD(bool,
+                asyncWriteCoalesced,
+                (std::uint32_t key, std::string_view message),
+                ());
+
+    bool asyncWriteCoalesced(std::uint32_t key, SerialMessage message)
+    {
+        return asyncWriteCoalesced(key, message.view());
+    }
+};
+
+struct FleetPowerControllerTest : public ::testing::Test
+{
+    FleetPowerController<MockSerialPortManager> mFleetPowerController{
+        [this](const std::filesystem::path& serialDevice, int) {
+            mOpenedDevices.push_back(serialDevice);
+            auto serialPortManager
+                = std::make_unique<::testing::NiceMock<MockSerialPortManager>>();
+            mSerialPortManagers.push_back(serialPortManager.get());
+
+            return serialPortManager;
+        }};
+    std::vector<std::filesystem::path> mOpenedDevices;
+    std::vector<MockSerialPortManager*> mSerialPortManagers;
+};
+
+TEST_F(FleetPowerControllerTest,
+       addCamera_WhenCamerasShareDevice_WillOpenDeviceOnce)
+{
+    mFleetPowerController.addCamera(1, kSharedBus, kBaudRate, 1);
+    mFleetPowerController.addCamera(2, kSharedBus, kBaudRate, 2);
+    mFleetPowerController.addCamera(3, kDedicatedPort, kBaudRate);
+
+    EXPECT_EQ(mOpenedDevices,
+              (std::vector<std::filesystem::path>{kSharedBus, kDedicatedPort}));
+}
+
+TEST_F(FleetPowerControllerTest,
+       addCamera_WhenDeviceOpenedWithOtherBaudRate_WillThrow)
+{
+    mFleetPowerController.addCamera(1, kSharedBus, kBaudRate, 1);
+
+    EXPECT_ANY_THROW(
+        mFleetPowerController.addCamera(2, kSharedBus, kBaudRate * 2, 2));
+}
+
+TEST_F(FleetPowerControllerTest, addCamera_WhenCameraAlreadyAdded_WillThrow)
+{
+    mFleetPowerController.addCamera(1, kSharedBus, kBaudRate, 1);
+
+    EXPECT_ANY_THROW(
+        mFleetPowerController.addCamera(1, kSharedBus, kBaudRate, 2));
+}
+
+TEST_F(FleetPowerControllerTest,
+       turnOnCamera_WhenAloneOnPort_WillSendUnaddressedCommand)
+{
+    mFleetPowerController.addCamera(7, kDedicatedPort, kBaudRate);
+
+    EXPECT_CALL(*mSerialPortManagers.front(), asyncWriteCoalesced(7, "ON"sv));
+    mFleetPowerController.turnOnCamera(7);
+}
+
+TEST_F(FleetPowerControllerTest,
+       turnOffCamera_WhenOnSharedBus_WillSendAddressedCommand)
+{
+    mFleetPowerController.addCamera(7, kSharedBus, kBaudRate, 3);
+
+    EXPECT_CALL(*mSerialPortManagers.front(),
+                asyncWriteCoalesced(7, "3:OFF\n"sv));
+    mFleetPowerController.turnOffCamera(7);
+}
+
+TEST_F(FleetPowerControllerTest,
+       turnOnCamera_WhenCompactBinary_WillSendOpcodeAddressAndChecksum)
+{
+    mFleetPowerController.addCamera(
+        7, kSharedBus, kBaudRate, 3, WireProtocol::CompactBinary);
+
+    EXPECT_CALL(*mSerialPortManagers.front(),
+                asyncWriteCoalesced(7, "\x01\x03\xFC"sv));
+    mFleetPowerController.turnOnCamera(7);
+}
+
+TEST_F(FleetPowerControllerTest, turnOnCamera_WhenUnknownCamera_WillThrow)
+{
+    EXPECT_ANY_THROW(mFleetPowerController.turnOnCamera(7));
+}
+
+TEST_F(FleetPowerControllerTest,
+       turnOnCameras_WhenGroupOnSharedBus_WillSendEveryCameraThroughOnePort)
+{
+    const std::array<CameraId, 3> group{1, 2, 3};
+    for (const auto cameraId : group)
+    {
+        mFleetPowerController.addCamera(
+            cameraId, kSharedBus, kBaudRate, static_cast<std::uint8_t>(cameraId));
+    }
+
+    InSequence inSequence;
+    EXPECT_CALL(*mSerialPortManagers.front(),
+                asyncWriteCoalesced(1, "1:ON\n"sv));
+    EXPECT_CALL(*mSerialPortManagers.front(),
+                asyncWriteCoalesced(2, "2:ON\n"sv));
+    EXPECT_CALL(*mSerialPortManagers.front(),
+                asyncWriteCoalesced(3, "3:ON\n"sv));
+    mFleetPowerController.turnOnCameras(group);
+}
+
+TEST_F(FleetPowerControllerTest,
+       turnOffCamera_WhenPortRejectsCommand_WillReturnFalse)
+{
+    mFleetPowerController.addCamera(7, kDedicatedPort, kBaudRate);
+
+    EXPECT_CALL(*mSerialPortManagers.front(), asyncWriteCoalesced(7, "OFF"sv))
+        .WillOnce(Return(false));
+    EXPECT_FALSE(mFleetPowerController.turnOffCamera(7));
+}
+
+TEST_F(FleetPowerControllerTest,
+       turnOnCameras_WhenOneCommandRejected_WillSendTheRestAndReturnFalse)
+{
+    const std::array<CameraId, 3> group{1, 2, 3};
+    for (const auto cameraId : group)
+    {
+        mFleetPowerController.addCamera(
+            cameraId, kSharedBus, kBaudRate, static_cast<std::uint8_t>(cameraId));
+    }
+
+    InSequence inSequence;
+    EXPECT_CALL(*mSerialPortManagers.front(),
+                asyncWriteCoalesced(1, "1:ON\n"sv))
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mSerialPortManagers.front(),
+                asyncWriteCoalesced(2, "2:ON\n"sv))
+        .WillOnce(Return(false));
+    EXPECT_CALL(*mSerialPortManagers.front(),
+                asyncWriteCoalesced(3, "3:ON\n"sv))
+        .WillOnce(Return(true));
+    EXPECT_FALSE(mFleetPowerController.turnOnCameras(group));
+}
+
+TEST(FleetPowerControllerOnSimulatedBusTest,
+     turnOnCameras_WhenBatchedOnSharedBus_WillKeepTheCommandsApart)
+{
+    SimulatedSerialDevice simulatedSerialDevice;
+    FleetPowerController<AsioSerialPortManager> fleetPowerController{
+        [&simulatedSerialDevice](const std::filesystem::path&, int baudRate) {
+            auto asioSerialPortManager
+                = std::make_unique<AsioSerialPortManager>(
+                    simulatedSerialDevice.serialDevice(), baudRate);
+            // Long enough for the whole group to leave in a single write
+            asioSerialPortManager->setBatchingPolicy({100ms});
+
+            return asioSerialPortManager;
+        }};
+    const std::array<CameraId, 3> group{1, 2, 3};
+    for (const auto cameraId : group)
+    {
+        fleetPowerController.addCamera(
+            cameraId, kSharedBus, kBaudRate, static_cast<std::uint8_t>(cameraId));
+    }
+
+    EXPECT_TRUE(fleetPowerController.turnOnCameras(group));
+    fleetPowerController.drain();
+
+    ASSERT_TRUE(simulatedSerialDevice.waitForBytesFromHost(15));
+    EXPECT_EQ(simulatedSerialDevice.received(), "1:ON\n2:ON\n3:ON\n");
+}
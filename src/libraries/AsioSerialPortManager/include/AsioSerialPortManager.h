@@ -1,21 +1,230 @@
 #ifndef BREAKTHEDEPENDENCY_ASIOSERIALPORTMANAGER_H
 #define BREAKTHEDEPENDENCY_ASIOSERIALPORTMANAGER_H
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
 #include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
 
 #include <asio.hpp>
 
+#include "CommandRing.h"
+#include "FrameParser.h"
+#include "SerialMessage.h"
+#include "WriteMetrics.h"
+
+/// Turns an asio completion handler into a copyable callable that posts its
+/// arguments over to the executor associated with the handler, which is kept
+/// busy until then. The handler therefore runs where the operation was
+/// initiated from, e.g. on the thread resuming an awaiting coroutine, and
+/// neither on the thread that completed the operation nor from within the
+/// initiating function.
+template<typename Handler>
+auto postToAssociatedExecutor(Handler handler)
+{
+    auto work = asio::make_work_guard(handler);
+    return [sharedHandler = std::make_shared<Handler>(std::move(handler)),
+            work](auto... arguments) mutable {
+        asio::post(work.get_executor(), [sharedHandler, arguments...] {
+            (*sharedHandler)(arguments...);
+        });
+        work.reset();
+    };
+}
+
 class AsioSerialPortManager
 {
 public:
+    using WriteHandler
+        = std::function<void(std::error_code error, std::size_t bytesWritten)>;
+    using CoalescingKey = std::uint32_t;
+    using FrameHandler  = std::function<void(std::string_view frame)>;
+    /// Every handler of a manager runs through its strand, so they never run
+    /// concurrently even when the I/O context is run by several threads
+    using Executor = asio::strand<asio::io_context::executor_type>;
+
+    /// Controls how queued messages are gathered into a single scatter-gather
+    /// write. Messages that arrive while a write is in progress are always
+    /// batched, the window additionally holds back the first message of a
+    /// burst so that the rest of the burst can join it, unless the byte budget
+    /// is already queued when the burst starts.
+    ///
+    /// Once a batch has been written its bytes still wait in the driver until
+    /// the port has sent them. The next batch is held back while more than
+    /// maxDriverBacklogBytes are estimated to be waiting there, so that an
+    /// urgent message is not queued behind them. The estimate assumes the
+    /// port sends ten bits per byte at its baud rate, as the output queue of
+    /// the driver cannot be asked for on every kind of port. The largest
+    /// std::size_t never holds a batch back.
+    struct BatchingPolicy
+    {
+        std::chrono::steady_clock::duration window{};
+        std::size_t maxBatchBytes{512};
+        std::size_t maxDriverBacklogBytes{64};
+    };
+
+    /// Settings of the serial port. Those that are not set are left as the
+    /// driver has them.
+    struct PortOptions
+    {
+        unsigned int baudRate{9600};
+        std::optional<unsigned int> characterSize;
+        std::optional<asio::serial_port_base::parity::type> parity;
+        std::optional<asio::serial_port_base::stop_bits::type> stopBits;
+        std::optional<asio::serial_port_base::flow_control::type> flowControl;
+        /// VMIN and VTIME of termios, i.e. how many bytes a read waits for
+        /// and for how many tenths of a second
+        std::optional<std::uint8_t> minimumReadBytes;
+        std::optional<std::uint8_t> readTimeoutDeciseconds;
+        /// How long an FTDI USB adapter holds back received bytes that do not
+        /// fill a USB packet, from 1ms to 255ms, set through sysfs
+        std::optional<std::chrono::milliseconds> ftdiLatencyTimer;
+    };
+
+    /// Does not touch the device, it is opened by the first write or by
+    /// warmUp(). Writes queued while the device cannot be opened complete
+    /// with the error and the next write tries to open it again.
     AsioSerialPortManager(std::filesystem::path serialDevice, int baudRate);
+    /// Runs on an I/O context shared with other managers, e.g. one run by an
+    /// IoThreadPool, instead of on an I/O context and thread of its own.
+    /// The context has to be running until the manager is destroyed, there is
+    /// nothing to start() and calls that wait for the manager, e.g. drain(),
+    /// must not be made from the threads running the context. If it has been
+    /// stopped, the destructor runs the manager's handlers still left on it.
+    AsioSerialPortManager(asio::io_context& ioContext,
+                          std::filesystem::path serialDevice,
+                          int baudRate);
+    ~AsioSerialPortManager();
+
+    /// Opens the device ahead of the first write on the thread running the
+    /// manager's I/O service, so that managers that have been started open
+    /// their ports in parallel. The future throws std::system_error if the
+    /// device cannot be opened.
+    std::future<void> warmUp();
+
+    /// Changes the settings of the open port, e.g. to a higher baud rate once
+    /// a handshake has agreed on it, or keeps them for when it is opened.
+    /// The port is neither closed nor are queued messages dropped. The
+    /// settings change between two batches, once the bytes written so far
+    /// have left the port, so queued messages that have not been written yet
+    /// go out with the new settings. Meanwhile the thread running the
+    /// manager's I/O service is blocked. The future throws std::system_error
+    /// if the port rejects the settings, which leaves the old ones in place.
+    std::future<void> reconfigure(PortOptions portOptions);
+
+    /// Blocks until the message has been written, throws on failure and with
+    /// `asio::error::no_buffer_space` if the queue is full and the message
+    /// rejected
+    void asioWrite(SerialMessage message);
+
+    /// Queues the message behind any pending writes and returns immediately.
+    /// The payload is not copied, the queue shares it with the caller until
+    /// `onWritten` is invoked once the message has left the serial port, from
+    /// whichever thread is running the manager's I/O service.
+    /// Safe to call from several threads, each message is written as a whole.
+    /// Returns false if the queue is full and the backpressure policy is
+    /// Backpressure::FailFast, in which case `onWritten` is not invoked.
+    bool asyncWrite(SerialMessage message, WriteHandler onWritten = {});
 
-    void asioWrite(std::string_view message);
+    /// Asio flavoured asyncWrite() completing through a completion token,
+    /// e.g. `co_await manager.asyncWrite(message, asio::use_awaitable)` from a
+    /// coroutine, which resumes on its own executor once the message has left
+    /// the serial port. Completes with `asio::error::no_buffer_space` where
+    /// asyncWrite() would return false.
+    template<typename CompletionToken>
+    requires(!std::is_convertible_v<CompletionToken, WriteHandler>)
+    auto asyncWrite(SerialMessage message, CompletionToken&& token)
+    {
+        return asio::async_initiate<CompletionToken,
+                                    void(std::error_code, std::size_t)>(
+            [this](auto handler, SerialMessage queuedMessage) {
+                WriteHandler onWritten
+                    = postToAssociatedExecutor(std::move(handler));
+                if (!asyncWrite(std::move(queuedMessage), onWritten))
+                {
+                    onWritten(asio::error::no_buffer_space, 0);
+                }
+            },
+            token,
+            std::move(message));
+    }
+
+    /// Like asyncWrite() but queued in a lane of its own that the writer always
+    /// empties first, e.g. for a safety shutdown. Urgent messages go out in
+    /// batches of their own as soon as the write in progress, if any, has
+    /// completed. They therefore wait for at most one batch of
+    /// BatchingPolicy::maxBatchBytes, BatchingPolicy::maxDriverBacklogBytes
+    /// and the urgent messages ahead of them to be sent, however much other
+    /// traffic is queued.
+    bool asyncWriteUrgent(SerialMessage message, WriteHandler onWritten = {});
+
+    /// Like asyncWrite() but a message that is about to be written in the same
+    /// batch under the same key is replaced in place, e.g. to collapse ON/OFF
+    /// toggles of one camera. The replaced message completes with
+    /// `asio::error::operation_aborted`.
+    bool asyncWriteCoalesced(CoalescingKey key,
+                             SerialMessage message,
+                             WriteHandler onWritten = {});
+
+    /// Keeps a read outstanding on the serial port whenever it is open and
+    /// hands every frame that `frameParser` finds in the received bytes to
+    /// `onFrame`, on the thread running the manager's I/O service. The frame
+    /// is only valid during the call. Reading never holds up the writes, the
+    /// next read is started as soon as the received bytes have been parsed.
+    /// An empty handler stops reading. The frames have a single owner, e.g. a
+    /// RequestPipeline: setting a handler while another one is set throws
+    /// std::logic_error until the owner has set an empty handler.
+    void setFrameHandler(FrameParser frameParser, FrameHandler onFrame);
+
+    void setBatchingPolicy(BatchingPolicy batchingPolicy);
+    /// Defaults to Backpressure::Block. Messages evicted under
+    /// Backpressure::DropOldest complete with `asio::error::operation_aborted`
+    /// on the thread of the producer that evicted them. Producers that would
+    /// block waiting for themselves are rejected as under
+    /// Backpressure::FailFast instead, i.e. those running on the manager's
+    /// I/O context and any on a manager that is neither started nor on a
+    /// shared I/O context.
+    void setBackpressure(Backpressure backpressure);
+
+    /// Runs the completion handlers that are ready without blocking. On a
+    /// shared I/O context those of the other managers are run as well.
+    std::size_t poll();
+
+    /// Starts a background thread that runs the manager's I/O context so
+    /// that queued writes make progress without the caller's involvement
+    void start();
+    /// Blocks until every write queued so far has completed
+    void drain();
+    /// Drains the queued writes, stops reading and joins the background
+    /// thread, or on a shared I/O context waits until none of the manager's
+    /// handlers is left on it. Reading resumes with start() or
+    /// setFrameHandler().
+    void stop();
+
+    /// Safe to call from any thread while the manager is in use
+    WriteMetricsSnapshot metrics() const;
+    /// Covers the messages written by asyncWriteUrgent() only
+    WriteMetricsSnapshot urgentMetrics() const;
+
+    /// Runs handlers on the manager's strand, e.g. those of timers that
+    /// belong together with the manager's writes and frames
+    Executor executor();
 
 private:
-    asio::io_service mIoService;
-    asio::serial_port mSerialPort{mIoService};
+    /// Everything the manager writes and reads with. Substitutes of the
+    /// manager linked in its place define one of their own, so that they
+    /// neither build nor depend on the state of this one.
+    struct Impl;
+
+    std::unique_ptr<Impl> mImpl;
 };
 
 #endif // BREAKTHEDEPENDENCY_ASIOSERIALPORTMANAGER_H
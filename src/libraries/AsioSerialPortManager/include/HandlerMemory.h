@@ -0,0 +1,102 @@
+#ifndef BREAKTHEDEPENDENCY_HANDLERMEMORY_H
+#define BREAKTHEDEPENDENCY_HANDLERMEMORY_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/// Storage for the asio operations of a handler of which at most one is
+/// outstanding at any time, e.g. the write on a serial port. asio only
+/// recycles small operation objects on its own, and only on the threads that
+/// run the I/O context, so larger ones such as scatter-gather writes and
+/// anything started from another thread would otherwise hit the heap every
+/// time. A handler posted to a strand needs a second block, since the strand
+/// schedules itself with the handler's allocator while the handler waits in
+/// its queue.
+class HandlerMemory
+{
+public:
+    explicit HandlerMemory(std::size_t capacity, std::size_t blocks = 1)
+        : mCapacity{capacity}
+        , mBlocks{blocks}
+        , mStorage{std::make_unique<std::byte[]>(capacity * blocks)}
+        , mInUse{std::make_unique<std::atomic<bool>[]>(blocks)}
+    {
+    }
+
+    HandlerMemory(const HandlerMemory&) = delete;
+    HandlerMemory& operator=(const HandlerMemory&) = delete;
+
+    /// Falls back to the heap if every block is taken or too small
+    void* allocate(std::size_t size)
+    {
+        for (std::size_t block = 0; size <= mCapacity && block < mBlocks;
+             ++block)
+        {
+            if (!mInUse[block].exchange(true))
+            {
+                return mStorage.get() + block * mCapacity;
+            }
+        }
+
+        return ::operator new(size);
+    }
+
+    void deallocate(void* pointer)
+    {
+        const auto* const bytes = static_cast<std::byte*>(pointer);
+        const auto* const storage = mStorage.get();
+        if (bytes >= storage && bytes < storage + mBlocks * mCapacity)
+        {
+            const auto block
+                = static_cast<std::size_t>(bytes - storage) / mCapacity;
+            mInUse[block].store(false);
+            return;
+        }
+
+        ::operator delete(pointer);
+    }
+
+private:
+    std::size_t mCapacity;
+    std::size_t mBlocks;
+    std::unique_ptr<std::byte[]> mStorage;
+    std::unique_ptr<std::atomic<bool>[]> mInUse;
+};
+
+/// Hands HandlerMemory to asio through a handler's associated allocator
+template<typename T>
+struct HandlerAllocator
+{
+    using value_type = T;
+
+    HandlerAllocator(HandlerMemory* memory)
+        : mMemory{memory}
+    {
+    }
+
+    template<typename U>
+    HandlerAllocator(const HandlerAllocator<U>& other)
+        : mMemory{other.mMemory}
+    {
+    }
+
+    T* allocate(std::size_t count)
+    {
+        return static_cast<T*>(mMemory->allocate(sizeof(T) * count));
+    }
+
+    void deallocate(T* pointer, std::size_t)
+    {
+        mMemory->deallocate(pointer);
+    }
+
+    bool operator==(const HandlerAllocator& other) const
+    {
+        return mMemory == other.mMemory;
+    }
+
+    HandlerMemory* mMemory;
+};
+
+#endif // BREAKTHEDEPENDENCY_HANDLERMEMORY_H
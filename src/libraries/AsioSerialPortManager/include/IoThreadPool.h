@@ -0,0 +1,35 @@
+#ifndef BREAKTHEDEPENDENCY_IOTHREADPOOL_H
+#define BREAKTHEDEPENDENCY_IOTHREADPOOL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include <asio.hpp>
+
+/// Runs a single I/O context on a fixed number of threads, so that the
+/// AsioSerialPortManagers sharing it are served by that many cores instead of
+/// a reactor and a thread per serial port.
+class IoThreadPool
+{
+public:
+    explicit IoThreadPool(
+        std::size_t threads = std::max(1U, std::thread::hardware_concurrency()));
+    /// Waits for the handlers still queued, so the managers running on the
+    /// pool have to be destroyed first
+    ~IoThreadPool();
+
+    IoThreadPool(const IoThreadPool&) = delete;
+    IoThreadPool& operator=(const IoThreadPool&) = delete;
+
+    asio::io_context& ioContext();
+
+private:
+    asio::io_context mIoContext;
+    asio::executor_work_guard<asio::io_context::executor_type> mWorkGuard{
+        asio::make_work_guard(mIoContext)};
+    std::vector<std::thread> mThreads;
+};
+
+#endif // BREAKTHEDEPENDENCY_IOTHREADPOOL_H
@@ -1,14 +1,1194 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
 #include "AsioSerialPortManager.h"
+#include "HandlerMemory.h"
+
+#if !defined(ASIO_WINDOWS)
+#include <termios.h>
+#endif
+
+namespace
+{
+/// Calls `apply` with every option that asio knows about and is set
+template<typename Apply>
+void forEachAsioOption(const AsioSerialPortManager::PortOptions& portOptions,
+                       Apply apply)
+{
+    apply(asio::serial_port_base::baud_rate{portOptions.baudRate});
+    if (portOptions.characterSize)
+    {
+        apply(asio::serial_port_base::character_size{
+            *portOptions.characterSize});
+    }
+    if (portOptions.parity)
+    {
+        apply(asio::serial_port_base::parity{*portOptions.parity});
+    }
+    if (portOptions.stopBits)
+    {
+        apply(asio::serial_port_base::stop_bits{*portOptions.stopBits});
+    }
+    if (portOptions.flowControl)
+    {
+        apply(asio::serial_port_base::flow_control{*portOptions.flowControl});
+    }
+}
+
+#if !defined(ASIO_WINDOWS)
+std::error_code lastSystemError()
+{
+    return {errno, std::system_category()};
+}
+
+/// Only FTDI adapters expose the latency timer, other devices fail with
+/// std::errc::not_supported
+std::error_code setFtdiLatencyTimer(const std::filesystem::path& serialDevice,
+                                    std::chrono::milliseconds latency)
+{
+    if (latency < std::chrono::milliseconds{1}
+        || latency > std::chrono::milliseconds{255})
+    {
+        return std::make_error_code(std::errc::invalid_argument);
+    }
+
+    std::error_code error;
+    // The device is usually a symlink, e.g. set up by a udev rule
+    const auto device = std::filesystem::canonical(serialDevice, error);
+    if (error)
+    {
+        return error;
+    }
+
+    const auto latencyTimerPath
+        = std::filesystem::path{"/sys/bus/usb-serial/devices"}
+          / device.filename() / "latency_timer";
+    if (!std::filesystem::exists(latencyTimerPath, error))
+    {
+        return std::make_error_code(std::errc::not_supported);
+    }
+
+    std::ofstream latencyTimer{latencyTimerPath};
+    latencyTimer << latency.count() << std::flush;
+
+    return latencyTimer ? std::error_code{}
+                        : std::make_error_code(std::errc::io_error);
+}
+#endif
+} // namespace
+
+struct AsioSerialPortManager::Impl
+{
+    struct PendingReconfiguration
+    {
+        PortOptions portOptions;
+        std::promise<void> reconfigured;
+    };
+
+    struct PendingWrite
+    {
+        SerialMessage message;
+        WriteHandler onWritten;
+        std::optional<CoalescingKey> key;
+        [[no_unique_address]] WriteMetrics::Timestamp queuedAt{};
+        bool urgent{false};
+    };
+
+    /// Wakes the writer up on the I/O thread. The post it is passed to uses
+    /// dedicated memory so that producer threads never allocate.
+    struct WakeUpWriter
+    {
+        using allocator_type = HandlerAllocator<void>;
+
+        allocator_type get_allocator() const noexcept
+        {
+            return {&impl->mWakeUpMemory};
+        }
+
+        void operator()() const
+        {
+            impl->startBatch();
+        }
+
+        Impl* impl;
+    };
+
+    /// Cuts the batching window short for an urgent message
+    struct ExpediteWriter
+    {
+        using allocator_type = HandlerAllocator<void>;
+
+        allocator_type get_allocator() const noexcept
+        {
+            return {&impl->mExpediteMemory};
+        }
+
+        void operator()() const
+        {
+            impl->expedite();
+        }
+
+        Impl* impl;
+    };
+
+    struct BatchWritten
+    {
+        using allocator_type = HandlerAllocator<void>;
+
+        allocator_type get_allocator() const noexcept
+        {
+            return {&impl->mWriteMemory};
+        }
+
+        void operator()(std::error_code error, std::size_t bytesWritten) const
+        {
+            impl->onBatchWritten(error, bytesWritten);
+        }
+
+        Impl* impl;
+    };
+
+    struct BytesReceived
+    {
+        using allocator_type = HandlerAllocator<void>;
+
+        allocator_type get_allocator() const noexcept
+        {
+            return {&impl->mReadMemory};
+        }
+
+        void operator()(std::error_code error, std::size_t bytesReceived) const
+        {
+            impl->onBytesReceived(error, bytesReceived);
+        }
+
+        Impl* impl;
+    };
+
+    static constexpr std::size_t kCommandRingCapacity = 256;
+    static constexpr std::size_t kUrgentRingCapacity  = 64;
+    static constexpr std::size_t kReceiveBufferSize   = 4096;
+    // A start bit, eight data bits and a stop bit
+    static constexpr std::size_t kBitsPerByte = 10;
+
+    Impl(std::unique_ptr<asio::io_context> ownedIoContext,
+         asio::io_context* sharedIoContext,
+         std::filesystem::path serialDevice,
+         int baudRate);
+    ~Impl();
+
+    std::future<void> warmUp();
+    std::future<void> reconfigure(PortOptions portOptions);
+    void asioWrite(SerialMessage message);
+    bool asyncWrite(SerialMessage message, WriteHandler onWritten);
+    bool asyncWriteUrgent(SerialMessage message, WriteHandler onWritten);
+    bool asyncWriteCoalesced(CoalescingKey key,
+                             SerialMessage message,
+                             WriteHandler onWritten);
+    void setFrameHandler(FrameParser frameParser, FrameHandler onFrame);
+    void setBatchingPolicy(BatchingPolicy batchingPolicy);
+    void setBackpressure(Backpressure backpressure);
+    std::size_t poll();
+    void start();
+    void drain();
+    void stop();
+    WriteMetricsSnapshot metrics() const;
+    WriteMetricsSnapshot urgentMetrics() const;
+    Executor executor();
+
+
+    /// Whether something other than the caller runs the I/O context
+    bool runsInBackground() const;
+    /// Runs the I/O context meanwhile if nothing else does
+    void waitUntil(const std::atomic<bool>& flag, bool value);
+    std::error_code openIfNeeded();
+    /// With `afterDrain` the bytes written so far leave the port first
+    std::error_code applyPortOptions(const PortOptions& portOptions,
+                                     bool afterDrain);
+    void applyPendingReconfigurations();
+    void failQueuedWrites(std::error_code error);
+    bool submit(PendingWrite pendingWrite);
+    void wakeUpWriter();
+    void expedite();
+    void startBatch();
+    bool hasQueuedWrites() const;
+    void gatherUrgentBatch();
+    void gatherBatch();
+    std::chrono::microseconds transmitTime(std::size_t bytes) const;
+    std::size_t driverBacklogBytes() const;
+    void writeNextBatch();
+    void flush();
+    void onBatchWritten(std::error_code error, std::size_t bytesWritten);
+    void goIdle();
+    void complete(PendingWrite& write,
+                  std::error_code error,
+                  std::size_t bytes);
+    void startReading();
+    void stopReading();
+    void onBytesReceived(std::error_code error, std::size_t bytesReceived);
+
+    std::filesystem::path mSerialDevice;
+    PortOptions mPortOptions;
+    std::deque<PendingReconfiguration> mPendingReconfigurations;
+    // Handlers that never ran are destroyed along with the I/O context, so
+    // the memory they were allocated from has to outlive it
+    HandlerMemory mWakeUpMemory{128, 2};
+    HandlerMemory mExpediteMemory{128, 2};
+    HandlerMemory mWriteMemory{4096};
+    HandlerMemory mReadMemory{256};
+    std::unique_ptr<asio::io_context> mOwnedIoContext;
+    asio::io_context& mIoContext;
+    Executor mStrand;
+    asio::serial_port mSerialPort{mStrand};
+    asio::steady_timer mBatchTimer{mStrand};
+    BatchingPolicy mBatchingPolicy;
+    CommandRing<PendingWrite, kCommandRingCapacity> mCommandRing;
+    CommandRing<PendingWrite, kUrgentRingCapacity> mUrgentRing;
+    std::atomic<Backpressure> mBackpressure{Backpressure::Block};
+    std::atomic<std::size_t> mQueuedBytes{0};
+    std::atomic<bool> mWriterActive{false};
+    std::atomic<bool> mExpediteRequested{false};
+    std::optional<PendingWrite> mCarriedOverWrite;
+    std::optional<PendingWrite> mCarriedOverUrgentWrite;
+    std::vector<PendingWrite> mInFlightWrites;
+    std::vector<PendingWrite> mCompletedWrites;
+    std::vector<asio::const_buffer> mInFlightBuffers;
+    // Bytes written to the driver that it had not sent yet as of mBacklogAt
+    std::size_t mDriverBacklogBytes{0};
+    std::chrono::steady_clock::time_point mBacklogAt;
+    std::atomic<std::size_t> mOutstandingWrites{0};
+    std::optional<FrameParser> mFrameParser;
+    FrameHandler mOnFrame;
+    // Claimed on the caller's thread rather than on the strand, so that the
+    // second owner finds out right away instead of silently taking over
+    std::atomic<bool> mFrameHandlerClaimed{false};
+    std::array<char, kReceiveBufferSize> mReceiveBuffer{};
+    bool mReading{false};
+    // A read that completed with data just before stop() cancelled it would
+    // otherwise start the next one, and nothing would ever cancel that
+    bool mReadingStopped{false};
+    // Lets stop() on a shared I/O context wait for the aborted read
+    std::atomic<bool> mReadOutstanding{false};
+    [[no_unique_address]] WriteMetrics mWriteMetrics;
+    [[no_unique_address]] WriteMetrics mUrgentWriteMetrics;
+    std::optional<asio::executor_work_guard<asio::io_context::executor_type>>
+        mWorkGuard;
+    // Set by the destructor once a shared I/O context is no longer run
+    bool mSharedIoContextAbandoned{false};
+    std::thread mIoThread;
+};
 
 AsioSerialPortManager::AsioSerialPortManager(std::filesystem::path serialDevice,
                                              int baudRate)
+    : mImpl{std::make_unique<Impl>(std::make_unique<asio::io_context>(),
+                                   nullptr,
+                                   std::move(serialDevice),
+                                   baudRate)}
+{
+}
+
+AsioSerialPortManager::AsioSerialPortManager(asio::io_context& ioContext,
+                                             std::filesystem::path serialDevice,
+                                             int baudRate)
+    : mImpl{std::make_unique<Impl>(
+        nullptr, &ioContext, std::move(serialDevice), baudRate)}
+{
+}
+
+AsioSerialPortManager::~AsioSerialPortManager() = default;
+
+std::future<void> AsioSerialPortManager::warmUp()
+{
+    return mImpl->warmUp();
+}
+
+std::future<void> AsioSerialPortManager::reconfigure(PortOptions portOptions)
+{
+    return mImpl->reconfigure(std::move(portOptions));
+}
+
+void AsioSerialPortManager::asioWrite(SerialMessage message)
+{
+    mImpl->asioWrite(std::move(message));
+}
+
+bool AsioSerialPortManager::asyncWrite(SerialMessage message,
+                                       WriteHandler onWritten)
+{
+    return mImpl->asyncWrite(std::move(message), std::move(onWritten));
+}
+
+bool AsioSerialPortManager::asyncWriteUrgent(SerialMessage message,
+                                             WriteHandler onWritten)
+{
+    return mImpl->asyncWriteUrgent(std::move(message), std::move(onWritten));
+}
+
+bool AsioSerialPortManager::asyncWriteCoalesced(CoalescingKey key,
+                                                SerialMessage message,
+                                                WriteHandler onWritten)
+{
+    return mImpl->asyncWriteCoalesced(
+        key, std::move(message), std::move(onWritten));
+}
+
+void AsioSerialPortManager::setFrameHandler(FrameParser frameParser,
+                                            FrameHandler onFrame)
+{
+    mImpl->setFrameHandler(std::move(frameParser), std::move(onFrame));
+}
+
+void AsioSerialPortManager::setBatchingPolicy(BatchingPolicy batchingPolicy)
+{
+    mImpl->setBatchingPolicy(batchingPolicy);
+}
+
+void AsioSerialPortManager::setBackpressure(Backpressure backpressure)
+{
+    mImpl->setBackpressure(backpressure);
+}
+
+std::size_t AsioSerialPortManager::poll()
+{
+    return mImpl->poll();
+}
+
+void AsioSerialPortManager::start()
+{
+    mImpl->start();
+}
+
+void AsioSerialPortManager::drain()
+{
+    mImpl->drain();
+}
+
+void AsioSerialPortManager::stop()
+{
+    mImpl->stop();
+}
+
+WriteMetricsSnapshot AsioSerialPortManager::metrics() const
+{
+    return mImpl->metrics();
+}
+
+WriteMetricsSnapshot AsioSerialPortManager::urgentMetrics() const
+{
+    return mImpl->urgentMetrics();
+}
+
+AsioSerialPortManager::Executor AsioSerialPortManager::executor()
+{
+    return mImpl->executor();
+}
+
+AsioSerialPortManager::Impl::Impl(
+    std::unique_ptr<asio::io_context> ownedIoContext,
+    asio::io_context* sharedIoContext,
+    std::filesystem::path serialDevice,
+    int baudRate)
+    : mSerialDevice{std::move(serialDevice)}
+    , mOwnedIoContext{std::move(ownedIoContext)}
+    , mIoContext{sharedIoContext != nullptr ? *sharedIoContext
+                                            : *mOwnedIoContext}
+    , mStrand{asio::make_strand(mIoContext)}
+{
+    mPortOptions.baudRate = static_cast<unsigned int>(baudRate);
+    // A batch never holds more messages than the ring, so reserving up front
+    // keeps the write path free of allocations
+    mInFlightWrites.reserve(kCommandRingCapacity);
+    mCompletedWrites.reserve(kCommandRingCapacity);
+    mInFlightBuffers.reserve(kCommandRingCapacity);
+}
+
+AsioSerialPortManager::Impl::~Impl()
+{
+    if (mOwnedIoContext)
+    {
+        stop();
+        return;
+    }
+
+    // Handlers left on a shared I/O context would outlive the manager and the
+    // memory they were allocated from, so they all have to be done first.
+    // Nothing else runs a stopped context, so they are run here and it is
+    // left stopped.
+    mSharedIoContextAbandoned = mIoContext.stopped();
+    stop();
+    std::atomic<bool> shutDown{false};
+    asio::post(mStrand, [this, &shutDown] {
+        std::error_code ignored;
+        mBatchTimer.cancel();
+        mSerialPort.close(ignored);
+        shutDown.store(true);
+        shutDown.notify_all();
+    });
+    waitUntil(shutDown, true);
+    if (mSharedIoContextAbandoned)
+    {
+        mIoContext.stop();
+    }
+}
+
+std::future<void> AsioSerialPortManager::Impl::warmUp()
+{
+    auto opened = std::make_shared<std::promise<void>>();
+    auto future = opened->get_future();
+    asio::post(mStrand, [this, opened] {
+        if (const auto error = openIfNeeded())
+        {
+            opened->set_exception(
+                std::make_exception_ptr(std::system_error{error}));
+            return;
+        }
+        opened->set_value();
+    });
+
+    return future;
+}
+
+std::future<void>
+AsioSerialPortManager::Impl::reconfigure(PortOptions portOptions)
+{
+    auto pendingReconfiguration = std::make_shared<PendingReconfiguration>();
+    pendingReconfiguration->portOptions = std::move(portOptions);
+    auto future = pendingReconfiguration->reconfigured.get_future();
+    asio::post(mStrand, [this, pendingReconfiguration] {
+        mPendingReconfigurations.push_back(std::move(*pendingReconfiguration));
+        // Otherwise once the write in progress has completed
+        if (mInFlightWrites.empty())
+        {
+            applyPendingReconfigurations();
+        }
+    });
+
+    return future;
+}
+
+void AsioSerialPortManager::Impl::asioWrite(SerialMessage message)
+{
+    std::mutex completionMutex;
+    std::condition_variable completion;
+    std::optional<std::error_code> writeResult;
+    const auto queued = asyncWrite(
+        std::move(message), [&](std::error_code error, std::size_t) {
+            // Notify under the lock so that the waiting caller cannot return
+            // and destroy the condition variable before notify_one() is done
+            // with it
+            std::lock_guard lock{completionMutex};
+            writeResult = error;
+            completion.notify_one();
+        });
+    if (!queued)
+    {
+        throw std::system_error{asio::error::no_buffer_space};
+    }
+
+    if (runsInBackground())
+    {
+        std::unique_lock lock{completionMutex};
+        completion.wait(lock, [&writeResult] { return writeResult.has_value(); });
+    }
+    else
+    {
+        if (mIoContext.stopped())
+        {
+            mIoContext.restart();
+        }
+        while (!writeResult)
+        {
+            mIoContext.run_one();
+        }
+    }
+
+    if (*writeResult)
+    {
+        throw std::system_error{*writeResult};
+    }
+}
+
+bool AsioSerialPortManager::Impl::asyncWrite(SerialMessage message,
+                                             WriteHandler onWritten)
+{
+    return submit(
+        {std::move(message), std::move(onWritten), std::nullopt, {}, false});
+}
+
+bool AsioSerialPortManager::Impl::asyncWriteUrgent(SerialMessage message,
+                                                   WriteHandler onWritten)
+{
+    return submit(
+        {std::move(message), std::move(onWritten), std::nullopt, {}, true});
+}
+
+bool AsioSerialPortManager::Impl::asyncWriteCoalesced(CoalescingKey key,
+                                                      SerialMessage message,
+                                                      WriteHandler onWritten)
+{
+    return submit({std::move(message), std::move(onWritten), key, {}, false});
+}
+
+void AsioSerialPortManager::Impl::setFrameHandler(FrameParser frameParser,
+                                                  FrameHandler onFrame)
+{
+    if (!onFrame)
+    {
+        mFrameHandlerClaimed.store(false);
+    }
+    else if (mFrameHandlerClaimed.exchange(true))
+    {
+        throw std::logic_error("The frames already have a handler");
+    }
+
+    asio::post(mStrand,
+               [this,
+                frameParser = std::move(frameParser),
+                onFrame     = std::move(onFrame)]() mutable {
+                   mFrameParser    = std::move(frameParser);
+                   mOnFrame        = std::move(onFrame);
+                   mReadingStopped = false;
+                   startReading();
+               });
+}
+
+void AsioSerialPortManager::Impl::setBatchingPolicy(
+    BatchingPolicy batchingPolicy)
+{
+    asio::post(mStrand,
+               [this, batchingPolicy] { mBatchingPolicy = batchingPolicy; });
+}
+
+void AsioSerialPortManager::Impl::setBackpressure(Backpressure backpressure)
+{
+    mBackpressure.store(backpressure);
+}
+
+std::size_t AsioSerialPortManager::Impl::poll()
+{
+    if (mIoContext.stopped())
+    {
+        mIoContext.restart();
+    }
+
+    return mIoContext.poll();
+}
+
+void AsioSerialPortManager::Impl::start()
+{
+    if (runsInBackground())
+    {
+        return;
+    }
+
+    if (mIoContext.stopped())
+    {
+        mIoContext.restart();
+    }
+    mWorkGuard.emplace(asio::make_work_guard(mIoContext));
+    asio::post(mStrand, [this] {
+        mReadingStopped = false;
+        startReading();
+    });
+    mIoThread = std::thread{[this] { mIoContext.run(); }};
+}
+
+void AsioSerialPortManager::Impl::drain()
+{
+    if (runsInBackground())
+    {
+        for (auto outstandingWrites = mOutstandingWrites.load();
+             outstandingWrites != 0;
+             outstandingWrites = mOutstandingWrites.load())
+        {
+            mOutstandingWrites.wait(outstandingWrites);
+        }
+        return;
+    }
+
+    if (mIoContext.stopped())
+    {
+        mIoContext.restart();
+    }
+    while (mOutstandingWrites.load() != 0)
+    {
+        mIoContext.run_one();
+    }
+}
+
+void AsioSerialPortManager::Impl::stop()
+{
+    if (!mOwnedIoContext)
+    {
+        drain();
+        // Handlers queued on the strand before this one have run by the time
+        // it runs, the aborted read is the only one that may follow
+        std::atomic<bool> readingStopped{false};
+        asio::post(mStrand, [this, &readingStopped] {
+            stopReading();
+            readingStopped.store(true);
+            readingStopped.notify_all();
+        });
+        waitUntil(readingStopped, true);
+        waitUntil(mReadOutstanding, false);
+        return;
+    }
+
+    if (!mIoThread.joinable())
+    {
+        return;
+    }
+
+    // Without the work guard run() returns as soon as the queue is empty,
+    // which it never is while a read is outstanding
+    drain();
+    asio::post(mStrand, [this] { stopReading(); });
+    mWorkGuard.reset();
+    mIoThread.join();
+}
+
+bool AsioSerialPortManager::Impl::runsInBackground() const
+{
+    return (!mOwnedIoContext && !mSharedIoContextAbandoned)
+           || mIoThread.joinable();
+}
+
+void AsioSerialPortManager::Impl::waitUntil(const std::atomic<bool>& flag,
+                                            bool value)
+{
+    if (runsInBackground())
+    {
+        for (auto current = flag.load(); current != value;
+             current      = flag.load())
+        {
+            flag.wait(current);
+        }
+        return;
+    }
+
+    if (mIoContext.stopped())
+    {
+        mIoContext.restart();
+    }
+    while (flag.load() != value)
+    {
+        mIoContext.run_one();
+    }
+}
+
+std::error_code AsioSerialPortManager::Impl::openIfNeeded()
+{
+    std::error_code error;
+    if (mSerialPort.is_open())
+    {
+        return error;
+    }
+
+    mSerialPort.open(mSerialDevice.string(), error);
+    if (!error)
+    {
+        error = applyPortOptions(mPortOptions, false);
+    }
+    if (error)
+    {
+        std::error_code ignored;
+        mSerialPort.close(ignored);
+        return error;
+    }
+
+    if (mFrameParser)
+    {
+        mFrameParser->reset();
+    }
+    startReading();
+
+    return error;
+}
+
+std::error_code
+AsioSerialPortManager::Impl::applyPortOptions(const PortOptions& portOptions,
+                                              bool afterDrain)
+{
+    std::error_code error;
+#if defined(ASIO_WINDOWS)
+    forEachAsioOption(portOptions, [this, &error](const auto& option) {
+        if (!error)
+        {
+            mSerialPort.set_option(option, error);
+        }
+    });
+    if (!error
+        && (portOptions.minimumReadBytes || portOptions.readTimeoutDeciseconds
+            || portOptions.ftdiLatencyTimer))
+    {
+        error = std::make_error_code(std::errc::not_supported);
+    }
+    static_cast<void>(afterDrain);
+
+    return error;
+#else
+    // Everything is gathered into a single set of attributes, so that the
+    // port never runs with only some of the options changed
+    const auto fileDescriptor = mSerialPort.native_handle();
+    termios attributes{};
+    if (::tcgetattr(fileDescriptor, &attributes) != 0)
+    {
+        return lastSystemError();
+    }
+    const auto previousAttributes = attributes;
+    forEachAsioOption(portOptions, [&attributes, &error](const auto& option) {
+        if (!error)
+        {
+            option.store(attributes, error);
+        }
+    });
+    if (error)
+    {
+        return error;
+    }
+    if (portOptions.minimumReadBytes)
+    {
+        attributes.c_cc[VMIN] = *portOptions.minimumReadBytes;
+    }
+    if (portOptions.readTimeoutDeciseconds)
+    {
+        attributes.c_cc[VTIME] = *portOptions.readTimeoutDeciseconds;
+    }
+
+    if (::tcsetattr(
+            fileDescriptor, afterDrain ? TCSADRAIN : TCSANOW, &attributes)
+        != 0)
+    {
+        return lastSystemError();
+    }
+
+    // The only option outside the attributes, so it is set once they have
+    // been accepted and they are put back if it fails. Failing either way
+    // leaves the old options in place.
+    if (portOptions.ftdiLatencyTimer)
+    {
+        error = setFtdiLatencyTimer(mSerialDevice,
+                                    *portOptions.ftdiLatencyTimer);
+        if (error)
+        {
+            ::tcsetattr(fileDescriptor, TCSANOW, &previousAttributes);
+            return error;
+        }
+    }
+
+    return error;
+#endif
+}
+
+void AsioSerialPortManager::Impl::applyPendingReconfigurations()
+{
+    while (!mPendingReconfigurations.empty())
+    {
+        auto pendingReconfiguration
+            = std::move(mPendingReconfigurations.front());
+        mPendingReconfigurations.pop_front();
+
+        // A closed port picks the options up when it is opened
+        if (mSerialPort.is_open())
+        {
+            if (const auto error
+                = applyPortOptions(pendingReconfiguration.portOptions, true))
+            {
+                pendingReconfiguration.reconfigured.set_exception(
+                    std::make_exception_ptr(std::system_error{error}));
+                continue;
+            }
+        }
+
+        mPortOptions = pendingReconfiguration.portOptions;
+        pendingReconfiguration.reconfigured.set_value();
+    }
+}
+
+void AsioSerialPortManager::Impl::failQueuedWrites(std::error_code error)
+{
+    for (;;)
+    {
+        auto write = mCarriedOverUrgentWrite
+                         ? std::exchange(mCarriedOverUrgentWrite, {})
+                         : mUrgentRing.tryPop();
+        if (!write && mCarriedOverWrite)
+        {
+            write = std::exchange(mCarriedOverWrite, {});
+        }
+        if (!write)
+        {
+            write = mCommandRing.tryPop();
+        }
+        if (!write)
+        {
+            return;
+        }
+
+        mQueuedBytes -= write->message.size();
+        complete(*write, error, 0);
+    }
+}
+
+WriteMetricsSnapshot AsioSerialPortManager::Impl::metrics() const
+{
+    return mWriteMetrics.snapshot();
+}
+
+WriteMetricsSnapshot AsioSerialPortManager::Impl::urgentMetrics() const
+{
+    return mUrgentWriteMetrics.snapshot();
+}
+
+AsioSerialPortManager::Executor AsioSerialPortManager::Impl::executor()
 {
-    mSerialPort.open(serialDevice.c_str());
-    mSerialPort.set_option(
-        asio::serial_port_base::baud_rate(static_cast<unsigned int>(baudRate)));
+    return mStrand;
 }
 
-void AsioSerialPortManager::asioWrite(std::string_view message)
+bool AsioSerialPortManager::Impl::submit(PendingWrite pendingWrite)
 {
-    asio::write(mSerialPort, asio::buffer(message));
+    const auto bytes  = pendingWrite.message.size();
+    const auto urgent = pendingWrite.urgent;
+    pendingWrite.queuedAt = WriteMetrics::now();
+    // Accounted for before the push so that drain() cannot miss the write
+    ++mOutstandingWrites;
+    mQueuedBytes += bytes;
+
+    const auto onDropped = [this](PendingWrite dropped) {
+        mQueuedBytes -= dropped.message.size();
+        complete(dropped, asio::error::operation_aborted, 0);
+    };
+    auto backpressure = mBackpressure.load();
+    // Nobody else would make room for a producer that is the writer itself,
+    // e.g. a handler running on the manager's I/O context, or that has to
+    // run the writer once it returns because the manager is not started
+    if (backpressure == Backpressure::Block
+        && (!runsInBackground()
+            || mIoContext.get_executor().running_in_this_thread()))
+    {
+        backpressure = Backpressure::FailFast;
+    }
+    const auto result
+        = urgent ? mUrgentRing.push(pendingWrite, backpressure, onDropped)
+                 : mCommandRing.push(pendingWrite, backpressure, onDropped);
+    if (result == PushResult::Rejected)
+    {
+        mQueuedBytes -= bytes;
+        --mOutstandingWrites;
+        mOutstandingWrites.notify_all();
+        (urgent ? mUrgentWriteMetrics : mWriteMetrics).recordRejection();
+        return false;
+    }
+
+    wakeUpWriter();
+    // An active writer may be holding a batch back for its window, which an
+    // urgent message must not wait for
+    if (urgent && !mExpediteRequested.exchange(true))
+    {
+        asio::post(mStrand, ExpediteWriter{this});
+    }
+    return true;
+}
+
+void AsioSerialPortManager::Impl::wakeUpWriter()
+{
+    // Under load the writer is already active and picks up the new message
+    // on its own, so only the first message of a burst costs a post
+    if (!mWriterActive.exchange(true))
+    {
+        asio::post(mStrand, WakeUpWriter{this});
+    }
+}
+
+void AsioSerialPortManager::Impl::expedite()
+{
+    mExpediteRequested.store(false);
+    // Completes the wait with operation_aborted, which flushes right away.
+    // Without a wait pending the urgent lane is emptied by the next flush.
+    mBatchTimer.cancel();
+}
+
+void AsioSerialPortManager::Impl::startBatch()
+{
+    if (const auto error = openIfNeeded())
+    {
+        failQueuedWrites(error);
+        goIdle();
+        return;
+    }
+
+    if (mBatchingPolicy.window == std::chrono::steady_clock::duration::zero()
+        || mQueuedBytes.load() >= mBatchingPolicy.maxBatchBytes
+        || !mUrgentRing.empty())
+    {
+        writeNextBatch();
+        return;
+    }
+
+    mBatchTimer.expires_after(mBatchingPolicy.window);
+    mBatchTimer.async_wait([this](std::error_code) { writeNextBatch(); });
+}
+
+bool AsioSerialPortManager::Impl::hasQueuedWrites() const
+{
+    return mCarriedOverUrgentWrite || mCarriedOverWrite || !mUrgentRing.empty()
+           || !mCommandRing.empty();
+}
+
+void AsioSerialPortManager::Impl::gatherUrgentBatch()
+{
+    std::size_t batchBytes = 0;
+    for (;;)
+    {
+        auto next = mCarriedOverUrgentWrite
+                        ? std::exchange(mCarriedOverUrgentWrite, {})
+                        : mUrgentRing.tryPop();
+        if (!next)
+        {
+            break;
+        }
+
+        const auto bytes = next->message.size();
+        if (!mInFlightWrites.empty()
+            && batchBytes + bytes > mBatchingPolicy.maxBatchBytes)
+        {
+            mCarriedOverUrgentWrite = std::move(next);
+            break;
+        }
+
+        mQueuedBytes -= bytes;
+        batchBytes += bytes;
+        mInFlightWrites.push_back(std::move(*next));
+    }
+}
+
+void AsioSerialPortManager::Impl::gatherBatch()
+{
+    std::size_t batchBytes = 0;
+    for (;;)
+    {
+        auto next = mCarriedOverWrite ? std::exchange(mCarriedOverWrite, {})
+                                      : mCommandRing.tryPop();
+        if (!next)
+        {
+            break;
+        }
+
+        const auto bytes = next->message.size();
+        if (next->key)
+        {
+            const auto superseded = std::find_if(
+                mInFlightWrites.begin(),
+                mInFlightWrites.end(),
+                [&key = next->key](const auto& batched) {
+                    return batched.key == key;
+                });
+            if (superseded != mInFlightWrites.end())
+            {
+                mQueuedBytes -= bytes;
+                batchBytes = batchBytes - superseded->message.size() + bytes;
+                std::swap(*superseded, *next);
+                complete(*next, asio::error::operation_aborted, 0);
+                continue;
+            }
+        }
+
+        if (!mInFlightWrites.empty()
+            && batchBytes + bytes > mBatchingPolicy.maxBatchBytes)
+        {
+            mCarriedOverWrite = std::move(next);
+            break;
+        }
+
+        mQueuedBytes -= bytes;
+        batchBytes += bytes;
+        mInFlightWrites.push_back(std::move(*next));
+    }
+}
+
+std::chrono::microseconds
+AsioSerialPortManager::Impl::transmitTime(std::size_t bytes) const
+{
+    return std::chrono::microseconds{static_cast<std::int64_t>(
+        bytes * kBitsPerByte * 1'000'000 / mPortOptions.baudRate)};
+}
+
+std::size_t AsioSerialPortManager::Impl::driverBacklogBytes() const
+{
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - mBacklogAt);
+    if (elapsed >= transmitTime(mDriverBacklogBytes))
+    {
+        return 0;
+    }
+
+    return mDriverBacklogBytes
+           - static_cast<std::size_t>(elapsed.count()) * mPortOptions.baudRate
+                 / kBitsPerByte / 1'000'000;
+}
+
+void AsioSerialPortManager::Impl::writeNextBatch()
+{
+    const auto backlogBytes = driverBacklogBytes();
+    if (mCarriedOverUrgentWrite || !mUrgentRing.empty()
+        || backlogBytes <= mBatchingPolicy.maxDriverBacklogBytes)
+    {
+        flush();
+        return;
+    }
+
+    // expedite() cancels the wait, so urgent messages do not sit it out
+    mBatchTimer.expires_after(
+        transmitTime(backlogBytes - mBatchingPolicy.maxDriverBacklogBytes));
+    mBatchTimer.async_wait([this](std::error_code) { writeNextBatch(); });
+}
+
+void AsioSerialPortManager::Impl::flush()
+{
+    // Urgent messages never share a batch with the others, so that they are
+    // neither held up by the bytes of a large batch nor by its completion
+    if (mCarriedOverUrgentWrite || !mUrgentRing.empty())
+    {
+        gatherUrgentBatch();
+    }
+    else
+    {
+        gatherBatch();
+    }
+
+    if (mInFlightWrites.empty())
+    {
+        goIdle();
+        return;
+    }
+
+    mInFlightBuffers.clear();
+    for (const auto& write : mInFlightWrites)
+    {
+        mInFlightBuffers.push_back(
+            asio::buffer(write.message.data(), write.message.size()));
+    }
+
+    // Only one async_write is ever outstanding on the port, so the messages of
+    // different batches can never interleave on the wire. asio copies the
+    // buffer sequence, so hand it a view instead of the vector.
+    asio::async_write(mSerialPort,
+                      std::span<const asio::const_buffer>{mInFlightBuffers},
+                      BatchWritten{this});
+}
+
+void AsioSerialPortManager::Impl::onBatchWritten(std::error_code error,
+                                                 std::size_t bytesWritten)
+{
+    // Swapping keeps the capacity of both vectors around
+    std::swap(mCompletedWrites, mInFlightWrites);
+    mDriverBacklogBytes = driverBacklogBytes() + bytesWritten;
+    mBacklogAt          = std::chrono::steady_clock::now();
+    if (!mPendingReconfigurations.empty())
+    {
+        applyPendingReconfigurations();
+    }
+    if (hasQueuedWrites())
+    {
+        writeNextBatch();
+    }
+    else
+    {
+        goIdle();
+    }
+
+    for (auto& write : mCompletedWrites)
+    {
+        const auto writeBytes = std::min(write.message.size(), bytesWritten);
+        bytesWritten -= writeBytes;
+        complete(write, error, writeBytes);
+    }
+    mCompletedWrites.clear();
+}
+
+void AsioSerialPortManager::Impl::goIdle()
+{
+    mWriterActive.store(false);
+    // A producer that pushed while the writer was still active did not wake
+    // it up, so check again now that it is marked as idle
+    if (!mUrgentRing.empty() || !mCommandRing.empty())
+    {
+        wakeUpWriter();
+    }
+}
+
+void AsioSerialPortManager::Impl::complete(PendingWrite& write,
+                                           std::error_code error,
+                                           std::size_t bytes)
+{
+    mWriteMetrics.recordCompletion(write.queuedAt, error, bytes);
+    if (write.urgent)
+    {
+        mUrgentWriteMetrics.recordCompletion(write.queuedAt, error, bytes);
+    }
+    if (write.onWritten)
+    {
+        write.onWritten(error, bytes);
+    }
+
+    --mOutstandingWrites;
+    mOutstandingWrites.notify_all();
+}
+
+void AsioSerialPortManager::Impl::startReading()
+{
+    if (mReading || mReadingStopped || !mOnFrame || !mSerialPort.is_open())
+    {
+        return;
+    }
+
+    mReading = true;
+    mReadOutstanding.store(true);
+    mSerialPort.async_read_some(asio::buffer(mReceiveBuffer),
+                                BytesReceived{this});
+}
+
+void AsioSerialPortManager::Impl::stopReading()
+{
+    mReadingStopped = true;
+    if (mReading)
+    {
+        // Nothing is being written once drained, so only the read is aborted
+        std::error_code ignored;
+        mSerialPort.cancel(ignored);
+    }
+}
+
+void AsioSerialPortManager::Impl::onBytesReceived(std::error_code error,
+                                                  std::size_t bytesReceived)
+{
+    mReading = false;
+    // Otherwise stopped, no longer wanted or the device is gone, in which case
+    // retrying would only spin on the same error
+    if (!error && mOnFrame)
+    {
+        mFrameParser->feed(std::span{mReceiveBuffer.data(), bytesReceived},
+                           mOnFrame);
+        startReading();
+    }
+
+    if (!mReading)
+    {
+        mReadOutstanding.store(false);
+        mReadOutstanding.notify_all();
+    }
 }
@@ -0,0 +1,25 @@
+#include "IoThreadPool.h"
+
+IoThreadPool::IoThreadPool(std::size_t threads)
+    : mIoContext{static_cast<int>(threads)}
+{
+    mThreads.reserve(threads);
+    for (std::size_t thread = 0; thread < threads; ++thread)
+    {
+        mThreads.emplace_back([this] { mIoContext.run(); });
+    }
+}
+
+IoThreadPool::~IoThreadPool()
+{
+    mWorkGuard.reset();
+    for (auto& thread : mThreads)
+    {
+        thread.join();
+    }
+}
+
+asio::io_context& IoThreadPool::ioContext()
+{
+    return mIoContext;
+}
@@ -0,0 +1,718 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "AsioSerialPortManager.h"
+#include "IoThreadPool.h"
+#include "ResourceUsageFixture.h"
+#include "SimulatedSerialDeviceFixture.h"
+
+using namespace std::literals;
+
+namespace
+{
+const auto kBaudRate = 9600;
+const std::filesystem::path kMissingSerialDevice{"/dev/NoSuchCoolCompanyDevice"};
+} // namespace
+
+struct AsioSerialPortManagerTest : public SimulatedSerialDeviceFixture
+{
+    void collectFrames()
+    {
+        mAsioSerialPortManager.setFrameHandler(
+            FrameParser::delimited('\n', 64), [this](std::string_view frame) {
+                std::lock_guard lock{mFramesMutex};
+                mFrames.emplace_back(frame);
+                mFrameReceived.notify_all();
+            });
+    }
+
+    bool waitForFrames(std::size_t frames)
+    {
+        std::unique_lock lock{mFramesMutex};
+        return mFrameReceived.wait_for(lock, 5s, [this, frames] {
+            return mFrames.size() >= frames;
+        });
+    }
+
+    /// As seen through a descriptor of our own, the terminal attributes
+    /// belong to the device rather than to the manager's descriptor
+    termios portAttributes() const
+    {
+        const auto fileDescriptor
+            = ::open(mSerialDevice.c_str(), O_RDWR | O_NOCTTY);
+        termios attributes{};
+        EXPECT_EQ(::tcgetattr(fileDescriptor, &attributes), 0);
+        ::close(fileDescriptor);
+
+        return attributes;
+    }
+
+    std::mutex mFramesMutex;
+    std::condition_variable mFrameReceived;
+    std::vector<std::string> mFrames;
+    AsioSerialPortManager mAsioSerialPortManager{mSerialDevice, kBaudRate};
+};
+
+TEST_F(AsioSerialPortManagerTest, asioWrite_WhenNotStarted_WillWriteMessage)
+{
+    mAsioSerialPortManager.asioWrite("ON");
+
+    ASSERT_TRUE(mSimulatedSerialDevice.waitForBytesFromHost(2));
+    EXPECT_EQ(mSimulatedSerialDevice.received(), "ON");
+}
+
+TEST_F(AsioSerialPortManagerTest,
+       asyncWrite_WhenStarted_WillWriteMessagesInOrder)
+{
+    mAsioSerialPortManager.start();
+
+    mAsioSerialPortManager.asyncWrite("ON");
+    mAsioSerialPortManager.asyncWrite("OFF");
+    mAsioSerialPortManager.asyncWrite("ON");
+    mAsioSerialPortManager.drain();
+
+    ASSERT_TRUE(mSimulatedSerialDevice.waitForBytesFromHost(7));
+    EXPECT_EQ(mSimulatedSerialDevice.received(), "ONOFFON");
+}
+
+TEST_F(AsioSerialPortManagerTest,
+       asyncWrite_WhenPolled_WillWriteMessagesInOrder)
+{
+    std::vector<std::size_t> bytesWritten;
+    const auto onWritten = [&bytesWritten](std::error_code error,
+                                           std::size_t bytes) {
+        EXPECT_FALSE(error);
+        bytesWritten.push_back(bytes);
+    };
+
+    mAsioSerialPortManager.asyncWrite("ON", onWritten);
+    mAsioSerialPortManager.asyncWrite("OFF", onWritten);
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (bytesWritten.size() < 2
+           && std::chrono::steady_clock::now() < deadline)
+    {
+        mAsioSerialPortManager.poll();
+    }
+
+    EXPECT_EQ(bytesWritten, (std::vector<std::size_t>{2, 3}));
+    ASSERT_TRUE(mSimulatedSerialDevice.waitForBytesFromHost(5));
+    EXPECT_EQ(mSimulatedSerialDevice.received(), "ONOFF");
+}
+
+TEST_F(AsioSerialPortManagerTest,
+       asyncWrite_WhenStarted_WillCompleteOnTheIoThread)
+{
+    mAsioSerialPortManager.start();
+    std::thread::id completedOn;
+
+    mAsioSerialPortManager.asyncWrite(
+        "ON", [&completedOn](std::error_code, std::size_t) {
+            completedOn = std::this_thread::get_id();
+        });
+    mAsioSerialPortManager.drain();
+
+    EXPECT_NE(completedOn, std::thread::id{});
+    EXPECT_NE(completedOn, std::this_thread::get_id());
+}
+
+TEST_F(AsioSerialPortManagerTest,
+       asyncWrite_WhenBatchedWithinWindow_WillReportEachMessage)
+{
+    mAsioSerialPortManager.setBatchingPolicy({50ms, 512});
+    std::vector<std::size_t> bytesWritten;
+    const auto onWritten = [&bytesWritten](std::error_code error,
+                                           std::size_t bytes) {
+        EXPECT_FALSE(error);
+        bytesWritten.push_back(bytes);
+    };
+
+    mAsioSerialPortManager.asyncWrite("ON", onWritten);
+    mAsioSerialPortManager.asyncWrite("OFF", onWritten);
+    mAsioSerialPortManager.drain();
+
+    EXPECT_EQ(bytesWritten, (std::vector<std::size_t>{2, 3}));
+    ASSERT_TRUE(mSimulatedSerialDevice.waitForBytesFromHost(5));
+    EXPECT_EQ(mSimulatedSerialDevice.received(), "ONOFF");
+}
+
+TEST_F(AsioSerialPortManagerTest,
+       asyncWriteCoalesced_WhenSameKeyInOneBatch_WillOnlyWriteLatestMessage)
+{
+    mAsioSerialPortManager.setBatchingPolicy({50ms, 512});
+    std::vector<std::error_code> results;
+
+    mAsioSerialPortManager.asyncWriteCoalesced(
+        1, "ON", [&results](std::error_code error, std::size_t) {
+            results.push_back(error);
+        });
+    mAsioSerialPortManager.asyncWriteCoalesced(
+        1, "OFF", [&results](std::error_code error, std::size_t) {
+            results.push_back(error);
+        });
+    mAsioSerialPortManager.drain();
+
+    ASSERT_TRUE(mSimulatedSerialDevice.waitForBytesFromHost(3));
+    EXPECT_EQ(mSimulatedSerialDevice.received(), "OFF");
+    ASSERT_EQ(results.size(), 2U);
+    EXPECT_EQ(results[0], asio::error::operation_aborted);
+    EXPECT_FALSE(results[1]);
+}
+
+TEST_F(AsioSerialPortManagerTest,
+       asyncWriteUrgent_WhenQueuedBehindMessages_WillBeWrittenFirst)
+{
+    // Without being started the messages wait in the queue until drain()
+    mAsioSerialPortManager.asyncWrite("AAAA");
+    mAsioSerialPortManager.asyncWrite("BBBB");
+    mAsioSerialPortManager.asyncWriteUrgent("OFF");
+    mAsioSerialPortManager.drain();
+
+    ASSERT_TRUE(mSimulatedSerialDevice.waitForBytesFromHost(11));
+    EXPECT_EQ(mSimulatedSerialDevice.received(), "OFFAAAABBBB");
+}
+
+TEST_F(AsioSerialPortManagerTest,
+       asyncWriteUrgent_WhenBatchHeldBackByWindow_WillNotWaitForWindow)
+{
+    mAsioSerialPortManager.setBatchingPolicy({1h, 512});
+    mAsioSerialPortManager.start();
+
+    mAsioSerialPortManager.asyncWrite("ON");
+    // Lets the writer start waiting for the rest of the burst
+    std::this_thread::sleep_for(50ms);
+    mAsioSerialPortManager.asyncWriteUrgent("OFF");
+
+    ASSERT_TRUE(mSimulatedSerialDevice.waitForBytesFromHost(5));
+    EXPECT_EQ(mSimulatedSerialDevice.received(), "OFFON");
+}
+
+TEST_F(AsioSerialPortManagerTest,
+       asyncWrite_WhenQueueFullAndFailFast_WillRejectMessage)
+{
+    // Without being started nothing takes messages out of the queue
+    mAsioSerialPortManager.setBackpressure(Backpressure::FailFast);
+    for (auto i = 0; i < 256; ++i)
+    {
+        ASSERT_TRUE(mAsioSerialPortManager.asyncWrite("ON"));
+    }
+
+    EXPECT_FALSE(mAsioSerialPortManager.asyncWrite("ON"));
+}
+
+TEST_F(AsioSerialPortManagerTest,
+       asyncWrite_WhenQueueFullAndNotStarted_WillRejectInsteadOfBlocking)
+{
+    // Only the caller would take messages out of the queue, once it returns
+    for (auto i = 0; i < 256; ++i)
+    {
+        ASSERT_TRUE(mAsioSerialPortManager.asyncWrite("ON"));
+    }
+
+    EXPECT_FALSE(mAsioSerialPortManager.asyncWrite("ON"));
+    EXPECT_THROW(mAsioSerialPortManager.asioWrite("ON"), std::system_error);
+}
+
+TEST_F(AsioSerialPortManagerTest,
+       asyncWrite_WhenQueueFullOnIoThread_WillRejectInsteadOfBlocking)
+{
+    mAsioSerialPortManager.start();
+    // Keeps the I/O thread, i.e. the writer, busy while the queue fills up
+    std::promise<void> queueFilled;
+    std::promise<bool> lastQueued;
+    asio::post(mAsioSerialPortManager.executor(), [&] {
+        queueFilled.get_future().wait();
+        lastQueued.set_value(mAsioSerialPortManager.asyncWrite("ON"));
+    });
+    for (auto i = 0; i < 256; ++i)
+    {
+        ASSERT_TRUE(mAsioSerialPortManager.asyncWrite("ON"));
+    }
+    queueFilled.set_value();
+
+    EXPECT_FALSE(lastQueued.get_future().get());
+}
+
+TEST_F(AsioSerialPortManagerTest,
+       asyncWrite_WhenAwaited_WillResumeCoroutineOnItsOwnContext)
+{
+    mAsioSerialPortManager.start();
+    asio::io_context ioContext;
+    std::vector<std::size_t> bytesWritten;
+    std::vector<std::thread::id> resumedOn;
+
+    asio::co_spawn(
+        ioContext,
+        [&]() -> asio::awaitable<void> {
+            bytesWritten.push_back(co_await mAsioSerialPortManager.asyncWrite(
+                "ON", asio::use_awaitable));
+            resumedOn.push_back(std::this_thread::get_id());
+            bytesWritten.push_back(co_await mAsioSerialPortManager.asyncWrite(
+                "OFF", asio::use_awaitable));
+            resumedOn.push_back(std::this_thread::get_id());
+        },
+        asio::detached);
+    ioContext.run();
+
+    EXPECT_EQ(bytesWritten, (std::vector<std::size_t>{2, 3}));
+    EXPECT_EQ(resumedOn,
+              (std::vector<std::thread::id>{std::this_thread::get_id(),
+                                            std::this_thread::get_id()}));
+    ASSERT_TRUE(mSimulatedSerialDevice.waitForBytesFromHost(5));
+    EXPECT_EQ(mSimulatedSerialDevice.received(), "ONOFF");
+}
+
+TEST_F(AsioSerialPortManagerTest,
+       asyncWrite_WhenAwaitedAndQueueFull_WillThrowNoBufferSpace)
+{
+    mAsioSerialPortManager.setBackpressure(Backpressure::FailFast);
+    for (auto i = 0; i < 256; ++i)
+    {
+        ASSERT_TRUE(mAsioSerialPortManager.asyncWrite("ON"));
+    }
+    asio::io_context ioContext;
+    std::error_code result;
+
+    asio::co_spawn(
+        ioContext,
+        [&]() -> asio::awaitable<void> {
+            try
+            {
+                co_await mAsioSerialPortManager.asyncWrite("ON",
+                                                           asio::use_awaitable);
+            }
+            catch (const std::system_error& error)
+            {
+                result = error.code();
+            }
+        },
+        asio::detached);
+    ioContext.run();
+
+    EXPECT_EQ(result, asio::error::no_buffer_space);
+}
+
+TEST_F(AsioSerialPortManagerTest,
+       setFrameHandler_WhenDeviceSendsFrames_WillHandThemOver)
+{
+    mAsioSerialPortManager.start();
+    collectFrames();
+    mAsioSerialPortManager.warmUp().get();
+
+    mSimulatedSerialDevice.sendToHost("ON\nOF");
+    mSimulatedSerialDevice.sendToHost("F\n");
+
+    ASSERT_TRUE(waitForFrames(2));
+    EXPECT_EQ(mFrames, (std::vector<std::string>{"ON", "OFF"}));
+}
+
+TEST_F(AsioSerialPortManagerTest,
+       setFrameHandler_WhenFramesAlreadyHandled_WillThrow)
+{
+    collectFrames();
+
+    EXPECT_THROW(mAsioSerialPortManager.setFrameHandler(
+                     FrameParser::delimited('\n', 64), [](std::string_view) {}),
+                 std::logic_error);
+}
+
+TEST_F(AsioSerialPortManagerTest,
+       setFrameHandler_WhenPreviousHandlerCleared_WillTakeOver)
+{
+    mAsioSerialPortManager.start();
+    mAsioSerialPortManager.setFrameHandler(FrameParser::delimited('\n', 64),
+                                           [](std::string_view) {});
+    mAsioSerialPortManager.setFrameHandler(FrameParser::delimited('\n', 64),
+                                           {});
+    collectFrames();
+    mAsioSerialPortManager.warmUp().get();
+
+    mSimulatedSerialDevice.sendToHost("ON\n");
+
+    ASSERT_TRUE(waitForFrames(1));
+    EXPECT_EQ(mFrames, (std::vector<std::string>{"ON"}));
+}
+
+TEST_F(AsioSerialPortManagerTest,
+       setFrameHandler_WhenDeviceStreamsTelemetry_WillKeepUpAndKeepWriting)
+{
+    constexpr std::size_t kTelemetryFrames = 2000;
+    mAsioSerialPortManager.start();
+    collectFrames();
+    mAsioSerialPortManager.warmUp().get();
+
+    std::string telemetry;
+    for (std::size_t frame = 0; frame < kTelemetryFrames; ++frame)
+    {
+        telemetry += "TEMP:" + std::to_string(frame % 100) + "\n";
+    }
+    mSimulatedSerialDevice.sendToHost(telemetry);
+    mAsioSerialPortManager.asyncWrite("ON");
+    mAsioSerialPortManager.drain();
+
+    ASSERT_TRUE(waitForFrames(kTelemetryFrames));
+    EXPECT_EQ(mFrames.size(), kTelemetryFrames);
+    EXPECT_EQ(mFrames.back(), "TEMP:99");
+    ASSERT_TRUE(mSimulatedSerialDevice.waitForBytesFromHost(2));
+    EXPECT_EQ(mSimulatedSerialDevice.received(), "ON");
+}
+
+TEST_F(AsioSerialPortManagerTest,
+       reconfigure_WhenMessagesQueued_WillApplyOptionsWithoutLosingThem)
+{
+    mAsioSerialPortManager.asioWrite("ON");
+    mAsioSerialPortManager.asyncWrite("AAAA");
+    AsioSerialPortManager::PortOptions portOptions;
+    portOptions.baudRate               = 115200;
+    portOptions.minimumReadBytes       = 1;
+    portOptions.readTimeoutDeciseconds = 2;
+    auto reconfigured = mAsioSerialPortManager.reconfigure(portOptions);
+    mAsioSerialPortManager.asyncWrite("BBBB");
+    mAsioSerialPortManager.drain();
+
+    EXPECT_NO_THROW(reconfigured.get());
+    ASSERT_TRUE(mSimulatedSerialDevice.waitForBytesFromHost(10));
+    EXPECT_EQ(mSimulatedSerialDevice.received(), "ONAAAABBBB");
+    const auto attributes = portAttributes();
+    EXPECT_EQ(::cfgetospeed(&attributes), speed_t{B115200});
+    EXPECT_EQ(attributes.c_cc[VMIN], 1);
+    EXPECT_EQ(attributes.c_cc[VTIME], 2);
+}
+
+TEST_F(AsioSerialPortManagerTest,
+       reconfigure_WhenPortNotOpenYet_WillApplyOptionsWhenOpening)
+{
+    AsioSerialPortManager::PortOptions portOptions;
+    portOptions.baudRate = 19200;
+    auto reconfigured    = mAsioSerialPortManager.reconfigure(portOptions);
+    mAsioSerialPortManager.poll();
+    reconfigured.get();
+
+    mAsioSerialPortManager.asioWrite("ON");
+
+    const auto attributes = portAttributes();
+    EXPECT_EQ(::cfgetospeed(&attributes), speed_t{B19200});
+}
+
+TEST_F(AsioSerialPortManagerTest,
+       reconfigure_WhenOptionNotSupported_WillThrowAndKeepOldOptions)
+{
+    mAsioSerialPortManager.asioWrite("ON");
+    AsioSerialPortManager::PortOptions portOptions;
+    portOptions.baudRate = 115200;
+    // A pseudo-terminal is no FTDI adapter
+    portOptions.ftdiLatencyTimer = 1ms;
+    auto reconfigured = mAsioSerialPortManager.reconfigure(portOptions);
+    mAsioSerialPortManager.asyncWrite("OFF");
+    mAsioSerialPortManager.drain();
+
+    EXPECT_THROW(reconfigured.get(), std::system_error);
+    ASSERT_TRUE(mSimulatedSerialDevice.waitForBytesFromHost(5));
+    EXPECT_EQ(mSimulatedSerialDevice.received(), "ONOFF");
+    const auto attributes = portAttributes();
+    EXPECT_EQ(::cfgetospeed(&attributes), speed_t{B9600});
+}
+
+TEST_F(AsioSerialPortManagerTest,
+       reconfigure_WhenLatencyTimerRejected_WillRestoreTheOtherOptions)
+{
+    mAsioSerialPortManager.asioWrite("ON");
+    const auto attributesBefore = portAttributes();
+    AsioSerialPortManager::PortOptions portOptions;
+    portOptions.baudRate               = 115200;
+    portOptions.minimumReadBytes       = 1;
+    portOptions.readTimeoutDeciseconds = 2;
+    portOptions.ftdiLatencyTimer       = 1ms;
+
+    auto reconfigured = mAsioSerialPortManager.reconfigure(portOptions);
+    mAsioSerialPortManager.poll();
+
+    EXPECT_THROW(reconfigured.get(), std::system_error);
+    const auto attributes = portAttributes();
+    EXPECT_EQ(::cfgetospeed(&attributes), speed_t{B9600});
+    EXPECT_EQ(attributes.c_cc[VMIN], attributesBefore.c_cc[VMIN]);
+    EXPECT_EQ(attributes.c_cc[VTIME], attributesBefore.c_cc[VTIME]);
+}
+
+TEST_F(AsioSerialPortManagerTest, stop_WhenDeviceKeepsReporting_WillReturn)
+{
+    collectFrames();
+    mAsioSerialPortManager.start();
+    mAsioSerialPortManager.warmUp().get();
+    std::atomic<bool> stopped{false};
+    std::thread reporter{[this, &stopped] {
+        while (!stopped.load())
+        {
+            mSimulatedSerialDevice.sendToHost("ON\n");
+        }
+    }};
+    ASSERT_TRUE(waitForFrames(1));
+
+    mAsioSerialPortManager.stop();
+
+    stopped.store(true);
+    reporter.join();
+}
+
+TEST_F(AsioSerialPortManagerTest, warmUp_WhenStarted_WillOpenPort)
+{
+    mAsioSerialPortManager.start();
+
+    EXPECT_NO_THROW(mAsioSerialPortManager.warmUp().get());
+}
+
+TEST_F(AsioSerialPortManagerTest, metrics_WhenWritesComplete_WillCountThem)
+{
+    if (!WriteMetrics::kEnabled)
+    {
+        GTEST_SKIP() << "Built without instrumentation";
+    }
+
+    mAsioSerialPortManager.asioWrite("ON");
+    mAsioSerialPortManager.asioWrite("OFF");
+
+    const auto metrics = mAsioSerialPortManager.metrics();
+    EXPECT_EQ(metrics.writes, 2U);
+    EXPECT_EQ(metrics.bytesWritten, 5U);
+    EXPECT_EQ(metrics.failedWrites, 0U);
+    EXPECT_EQ(metrics.latency.count, 2U);
+}
+
+TEST(AsioSerialPortManagerOnPacedDeviceTest,
+     asyncWriteUrgent_WhenQueueSaturated_WillOvertakeTheDriverBacklog)
+{
+    constexpr auto kPacedBaudRate = 115200;
+    constexpr std::size_t kProbes = 9;
+    const AsioSerialPortManager::BatchingPolicy batchingPolicy{};
+    // Bulk traffic only consists of dots, so any other byte is a probe
+    std::atomic<std::size_t> probesReceived{0};
+    std::atomic<std::chrono::steady_clock::time_point> probeReceivedAt{};
+    SimulatedSerialDevice::Behaviour paced;
+    paced.baudRate = kPacedBaudRate;
+    SimulatedSerialDevice simulatedSerialDevice{
+        paced,
+        [&](std::string_view bytes,
+            std::chrono::steady_clock::time_point receivedAt) {
+            if (bytes.find_first_not_of('.') != std::string_view::npos)
+            {
+                probeReceivedAt.store(receivedAt);
+                ++probesReceived;
+                probesReceived.notify_all();
+            }
+        }};
+    AsioSerialPortManager asioSerialPortManager{
+        simulatedSerialDevice.serialDevice(), kPacedBaudRate};
+    asioSerialPortManager.setBatchingPolicy(batchingPolicy);
+    asioSerialPortManager.start();
+
+    std::atomic<bool> saturating{true};
+    std::thread bulkProducer{[&] {
+        const auto bulkMessage = SerialMessage::copyOf(std::string(32, '.'));
+        while (saturating.load())
+        {
+            // Blocks whenever the queue is full
+            asioSerialPortManager.asyncWrite(bulkMessage);
+        }
+    }};
+    std::this_thread::sleep_for(200ms);
+
+    std::vector<std::chrono::steady_clock::duration> latencies;
+    for (std::size_t probe = 0; probe < kProbes; ++probe)
+    {
+        std::this_thread::sleep_for(37ms);
+        const auto sentAt = std::chrono::steady_clock::now();
+        asioSerialPortManager.asyncWriteUrgent("!");
+        probesReceived.wait(probe);
+        latencies.push_back(probeReceivedAt.load() - sentAt);
+    }
+    saturating.store(false);
+    bulkProducer.join();
+    asioSerialPortManager.stop();
+
+    // The probe waits for the batch in progress and the driver backlog ahead
+    // of it to be sent. The device hands over the bytes it took in together
+    // once it is done with them, which can add a batch written after the
+    // probe. Twice that leaves room for the scheduler.
+    const auto bound = 2 * std::chrono::microseconds{
+        (2 * batchingPolicy.maxBatchBytes
+         + batchingPolicy.maxDriverBacklogBytes + 1)
+        * 10 * 1'000'000 / kPacedBaudRate};
+    std::sort(latencies.begin(), latencies.end());
+    EXPECT_LT(latencies[kProbes / 2], bound);
+}
+
+struct AsioSerialPortManagerResourceUsageTest : public ResourceUsageFixture
+{
+    AsioSerialPortManagerResourceUsageTest()
+    {
+        // Opens the port, which is not what is measured
+        mAsioSerialPortManager.asioWrite("OFF");
+    }
+
+    SimulatedSerialDevice mSimulatedSerialDevice;
+    AsioSerialPortManager mAsioSerialPortManager{
+        mSimulatedSerialDevice.serialDevice(), kBaudRate};
+};
+
+TEST_F(AsioSerialPortManagerResourceUsageTest,
+       asioWrite_WhenNotStarted_WillCostFiveAllocationsAndOneWrite)
+{
+    const auto resourceUsage
+        = measure([this] { mAsioSerialPortManager.asioWrite("ON"); });
+
+    // Pins down what a blocking write costs today rather than what it should.
+    // The allocations are the completion handler, two work-tracking copies
+    // of the strand and an operation for each of the two run_one() calls,
+    // since asio only recycles them within a call. Next to the write, the
+    // reactor makes two syscalls waiting for it.
+    EXPECT_EQ(resourceUsage.allocations, 5U) << resourceUsage;
+    EXPECT_EQ(resourceUsage.syscalls, 3U) << resourceUsage;
+    EXPECT_EQ(resourceUsage.writeSyscalls, 1U) << resourceUsage;
+}
+
+TEST_F(AsioSerialPortManagerResourceUsageTest,
+       asyncWrite_WhenStarted_WillNotAllocate)
+{
+    mAsioSerialPortManager.start();
+    for (auto write = 0; write < 3; ++write)
+    {
+        // Drained in between so that every write has to wake the writer up
+        const auto resourceUsage = measure([this] {
+            mAsioSerialPortManager.asyncWrite("ON");
+            mAsioSerialPortManager.asyncWriteUrgent("OFF");
+        });
+        mAsioSerialPortManager.drain();
+
+        EXPECT_EQ(resourceUsage.allocations, 0U) << resourceUsage;
+    }
+}
+
+TEST(AsioSerialPortManagerOnIoThreadPoolTest,
+     asyncWrite_WhenManyPortsShareThePool_WillWriteEachPortInOrder)
+{
+    constexpr std::size_t kPorts    = 8;
+    constexpr auto kMessagesPerPort = 100;
+    IoThreadPool ioThreadPool{2};
+    std::vector<std::unique_ptr<SimulatedSerialDevice>> simulatedSerialDevices;
+    std::vector<std::unique_ptr<AsioSerialPortManager>> asioSerialPortManagers;
+    for (std::size_t port = 0; port < kPorts; ++port)
+    {
+        simulatedSerialDevices.push_back(
+            std::make_unique<SimulatedSerialDevice>());
+        asioSerialPortManagers.push_back(
+            std::make_unique<AsioSerialPortManager>(
+                ioThreadPool.ioContext(),
+                simulatedSerialDevices.back()->serialDevice(),
+                kBaudRate));
+    }
+
+    std::string expected;
+    for (auto message = 0; message < kMessagesPerPort; ++message)
+    {
+        const auto payload = std::to_string(message) + ";";
+        expected += payload;
+        for (auto& asioSerialPortManager : asioSerialPortManagers)
+        {
+            asioSerialPortManager->asyncWrite(SerialMessage::copyOf(payload));
+        }
+    }
+    for (auto& asioSerialPortManager : asioSerialPortManagers)
+    {
+        asioSerialPortManager->drain();
+    }
+
+    for (auto& simulatedSerialDevice : simulatedSerialDevices)
+    {
+        ASSERT_TRUE(simulatedSerialDevice->waitForBytesFromHost(expected.size()));
+        EXPECT_EQ(simulatedSerialDevice->received(), expected);
+    }
+}
+
+TEST(AsioSerialPortManagerOnIoThreadPoolTest,
+     stop_WhenReadingFromSharedIoContext_WillReturn)
+{
+    IoThreadPool ioThreadPool{2};
+    SimulatedSerialDevice simulatedSerialDevice;
+    AsioSerialPortManager asioSerialPortManager{
+        ioThreadPool.ioContext(), simulatedSerialDevice.serialDevice(), kBaudRate};
+    std::promise<std::string> frameReceived;
+    asioSerialPortManager.setFrameHandler(
+        FrameParser::delimited('\n', 64),
+        [&frameReceived](std::string_view frame) {
+            frameReceived.set_value(std::string{frame});
+        });
+    asioSerialPortManager.warmUp().get();
+
+    simulatedSerialDevice.sendToHost("ON\n");
+
+    EXPECT_EQ(frameReceived.get_future().get(), "ON");
+    asioSerialPortManager.stop();
+}
+
+TEST(AsioSerialPortManagerOnIoThreadPoolTest,
+     destructor_WhenSharedIoContextStopped_WillCompleteQueuedWrites)
+{
+    SimulatedSerialDevice simulatedSerialDevice;
+    asio::io_context ioContext;
+    std::optional<std::error_code> result;
+    {
+        AsioSerialPortManager asioSerialPortManager{
+            ioContext, simulatedSerialDevice.serialDevice(), kBaudRate};
+        asioSerialPortManager.setFrameHandler(FrameParser::delimited('\n', 64),
+                                              [](std::string_view) {});
+        asioSerialPortManager.asyncWrite(
+            "ON",
+            [&result](std::error_code error, std::size_t) { result = error; });
+        ioContext.stop();
+    }
+
+    EXPECT_EQ(result, std::error_code{});
+    ASSERT_TRUE(simulatedSerialDevice.waitForBytesFromHost(2));
+    EXPECT_EQ(simulatedSerialDevice.received(), "ON");
+    EXPECT_TRUE(ioContext.stopped());
+}
+
+TEST(AsioSerialPortManagerWithoutDeviceTest,
+     warmUp_WhenDeviceDoesNotExist_WillFailTheFuture)
+{
+    AsioSerialPortManager asioSerialPortManager{kMissingSerialDevice,
+                                                kBaudRate};
+    asioSerialPortManager.start();
+
+    EXPECT_THROW(asioSerialPortManager.warmUp().get(), std::system_error);
+}
+
+TEST(AsioSerialPortManagerWithoutDeviceTest,
+     asyncWrite_WhenDeviceDoesNotExist_WillCompleteWithError)
+{
+    AsioSerialPortManager asioSerialPortManager{kMissingSerialDevice,
+                                                kBaudRate};
+    std::error_code result;
+
+    asioSerialPortManager.asyncWrite(
+        "ON", [&result](std::error_code error, std::size_t) { result = error; });
+    asioSerialPortManager.drain();
+
+    EXPECT_TRUE(result);
+    EXPECT_THROW(asioSerialPortManager.asioWrite("ON"), std::system_error);
+    if (WriteMetrics::kEnabled)
+    {
+        EXPECT_EQ(asioSerialPortManager.metrics().failedWrites, 2U);
+    }
+}
@@ -0,0 +1,110 @@
+#ifndef BREAKTHEDEPENDENCY_CAMERACOMMAND_H
+#define BREAKTHEDEPENDENCY_CAMERACOMMAND_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "SerialMessage.h"
+#include "WireProtocol.h"
+
+enum class CameraCommand
+{
+    TurnOn,
+    TurnOff
+};
+
+/// A compact command is an opcode, the bus address of the camera and a
+/// checksum that makes the three bytes add up to zero, modulo 256. Being of
+/// fixed size it needs no delimiter.
+inline constexpr std::size_t kCompactCameraCommandSize = 3;
+
+using CompactCameraCommand = std::array<char, kCompactCameraCommandSize>;
+
+struct DecodedCameraCommand
+{
+    CameraCommand command;
+    std::uint8_t busAddress;
+};
+
+constexpr std::uint8_t opcodeFor(CameraCommand command)
+{
+    return command == CameraCommand::TurnOn ? 0x01 : 0x02;
+}
+
+constexpr CompactCameraCommand encodeCompact(CameraCommand command,
+                                             std::uint8_t busAddress)
+{
+    const auto opcode = opcodeFor(command);
+    const auto checksum
+        = static_cast<std::uint8_t>(0x100 - ((opcode + busAddress) & 0xFF));
+
+    return {static_cast<char>(opcode),
+            static_cast<char>(busAddress),
+            static_cast<char>(checksum)};
+}
+
+/// Returns nothing for frames of the wrong size, with an unknown opcode or
+/// with a bad checksum
+constexpr std::optional<DecodedCameraCommand>
+decodeCompact(std::string_view frame)
+{
+    if (frame.size() != kCompactCameraCommandSize)
+    {
+        return std::nullopt;
+    }
+
+    const auto opcode     = static_cast<std::uint8_t>(frame[0]);
+    const auto busAddress = static_cast<std::uint8_t>(frame[1]);
+    const auto checksum   = static_cast<std::uint8_t>(frame[2]);
+    if (((opcode + busAddress + checksum) & 0xFF) != 0)
+    {
+        return std::nullopt;
+    }
+
+    for (const auto command : {CameraCommand::TurnOn, CameraCommand::TurnOff})
+    {
+        if (opcodeFor(command) == opcode)
+        {
+            return DecodedCameraCommand{command, busAddress};
+        }
+    }
+
+    return std::nullopt;
+}
+
+/// Every compact command there is, so that sending one never allocates
+inline constexpr auto kCompactCameraCommands = [] {
+    std::array<std::array<CompactCameraCommand, 256>, 2> commands{};
+    for (std::size_t busAddress = 0; busAddress < 256; ++busAddress)
+    {
+        const auto address = static_cast<std::uint8_t>(busAddress);
+        commands[0][busAddress] = encodeCompact(CameraCommand::TurnOn, address);
+        commands[1][busAddress]
+            = encodeCompact(CameraCommand::TurnOff, address);
+    }
+
+    return commands;
+}();
+
+/// The bus address is ignored by WireProtocol::Ascii
+inline SerialMessage encodeCameraCommand(WireProtocol wireProtocol,
+                                         CameraCommand command,
+                                         std::uint8_t busAddress)
+{
+    if (wireProtocol == WireProtocol::CompactBinary)
+    {
+        const auto& compact = kCompactCameraCommands
+            [command == CameraCommand::TurnOn ? 0 : 1][busAddress];
+
+        return SerialMessage::fromStaticStorage(
+            {compact.data(), compact.size()});
+    }
+
+    return command == CameraCommand::TurnOn ? SerialMessage{"ON"}
+                                            : SerialMessage{"OFF"};
+}
+
+#endif // BREAKTHEDEPENDENCY_CAMERACOMMAND_H
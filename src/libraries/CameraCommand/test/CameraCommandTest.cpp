@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include "CameraCommand.h"
+
+using namespace std::literals;
+
+static_assert(encodeCompact(CameraCommand::TurnOn, 0)
+              == CompactCameraCommand{'\x01', '\x00', '\xFF'});
+static_assert(encodeCompact(CameraCommand::TurnOff, 0xFE)
+              == CompactCameraCommand{'\x02', '\xFE', '\x00'});
+
+TEST(CameraCommandTest, encodeCameraCommand_WhenAscii_WillEncodeString)
+{
+    EXPECT_EQ(encodeCameraCommand(WireProtocol::Ascii, CameraCommand::TurnOn, 7),
+              "ON"sv);
+    EXPECT_EQ(
+        encodeCameraCommand(WireProtocol::Ascii, CameraCommand::TurnOff, 7),
+        "OFF"sv);
+}
+
+TEST(CameraCommandTest,
+     encodeCameraCommand_WhenCompactBinary_WillEncodeOpcodeAddressAndChecksum)
+{
+    const auto command = encodeCameraCommand(
+        WireProtocol::CompactBinary, CameraCommand::TurnOff, 3);
+
+    EXPECT_EQ(command, "\x02\x03\xFB"sv);
+}
+
+TEST(CameraCommandTest,
+     encodeCameraCommand_WhenCompactBinary_WillReferenceStaticTable)
+{
+    const auto command = encodeCameraCommand(
+        WireProtocol::CompactBinary, CameraCommand::TurnOn, 200);
+
+    EXPECT_EQ(command.data(), kCompactCameraCommands[0][200].data());
+}
+
+TEST(CameraCommandTest, decodeCompact_WhenEncoded_WillRoundTripEveryCommand)
+{
+    for (const auto command : {CameraCommand::TurnOn, CameraCommand::TurnOff})
+    {
+        for (unsigned busAddress = 0; busAddress < 256; ++busAddress)
+        {
+            const auto encoded
+                = encodeCompact(command, static_cast<std::uint8_t>(busAddress));
+
+            const auto decoded
+                = decodeCompact({encoded.data(), encoded.size()});
+
+            ASSERT_TRUE(decoded);
+            EXPECT_EQ(decoded->command, command);
+            EXPECT_EQ(decoded->busAddress, busAddress);
+        }
+    }
+}
+
+TEST(CameraCommandTest, decodeCompact_WhenChecksumWrong_WillReturnNothing)
+{
+    EXPECT_FALSE(decodeCompact("\x01\x03\xFB"sv));
+}
+
+TEST(CameraCommandTest, decodeCompact_WhenOpcodeUnknown_WillReturnNothing)
+{
+    EXPECT_FALSE(decodeCompact("\x03\x00\xFD"sv));
+}
+
+TEST(CameraCommandTest, decodeCompact_WhenWrongSize_WillReturnNothing)
+{
+    EXPECT_FALSE(decodeCompact("ON"sv));
+}
@@ -0,0 +1,197 @@
+#ifndef BREAKTHEDEPENDENCY_COMMANDRING_H
+#define BREAKTHEDEPENDENCY_COMMANDRING_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <utility>
+
+/// What a producer does when the ring is full
+enum class Backpressure
+{
+    Block,      // Wait until the consumer has made room
+    DropOldest, // Evict the oldest queued command to make room
+    FailFast    // Leave the command with the caller
+};
+
+enum class PushResult
+{
+    Pushed,
+    PushedDroppingOldest,
+    Rejected
+};
+
+/// Bounded lock-free queue with a fixed number of slots, after Dmitry Vyukov's
+/// bounded MPMC queue. It is meant to be used with many producers and a single
+/// consumer, however producers may evict the oldest command under
+/// Backpressure::DropOldest which is why popping is also multi-thread safe.
+/// Nothing is allocated after construction.
+template<typename T, std::size_t Capacity>
+class CommandRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of two");
+
+public:
+    CommandRing()
+    {
+        for (std::size_t i = 0; i < Capacity; ++i)
+        {
+            mSlots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    CommandRing(const CommandRing&) = delete;
+    CommandRing& operator=(const CommandRing&) = delete;
+
+    ~CommandRing()
+    {
+        while (tryPop())
+        {
+        }
+    }
+
+    /// Moves from `value` only if there was room for it
+    bool tryPush(T& value)
+    {
+        auto position = mEnqueuePosition.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            auto& slot          = mSlots[position & kMask];
+            const auto sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::ptrdiff_t>(sequence)
+                                    - static_cast<std::ptrdiff_t>(position);
+            if (difference == 0)
+            {
+                if (mEnqueuePosition.compare_exchange_weak(
+                        position, position + 1, std::memory_order_relaxed))
+                {
+                    new (slot.storage) T{std::move(value)};
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = mEnqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::optional<T> tryPop()
+    {
+        auto position = mDequeuePosition.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            auto& slot          = mSlots[position & kMask];
+            const auto sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::ptrdiff_t>(sequence)
+                                    - static_cast<std::ptrdiff_t>(position + 1);
+            if (difference == 0)
+            {
+                // Sequentially consistent, as is the counter of blocked
+                // producers, since a producer counts itself before it waits
+                // on the position. With weaker orderings we could miss that
+                // producer, which would then sleep through its only wakeup.
+                if (mDequeuePosition.compare_exchange_weak(position,
+                                                           position + 1))
+                {
+                    auto queued
+                        = std::launder(reinterpret_cast<T*>(slot.storage));
+                    std::optional<T> value{std::move(*queued)};
+                    queued->~T();
+                    slot.sequence.store(position + Capacity,
+                                        std::memory_order_release);
+                    if (mBlockedProducers.load() != 0)
+                    {
+                        mDequeuePosition.notify_all();
+                    }
+                    return value;
+                }
+            }
+            else if (difference < 0)
+            {
+                return std::nullopt;
+            }
+            else
+            {
+                position = mDequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Pushes according to the backpressure policy. Commands evicted under
+    /// Backpressure::DropOldest are handed to `onDropped`. The value is left
+    /// untouched if the result is PushResult::Rejected. Backpressure::Block
+    /// must not be used from the thread that pops, there is nobody else to
+    /// make room.
+    template<typename OnDropped>
+    PushResult push(T& value, Backpressure backpressure, OnDropped&& onDropped)
+    {
+        auto result = PushResult::Pushed;
+        for (;;)
+        {
+            // Observed before trying so that a pop in between wakes us up
+            const auto dequeuePosition = mDequeuePosition.load();
+            if (tryPush(value))
+            {
+                return result;
+            }
+
+            switch (backpressure)
+            {
+            case Backpressure::Block:
+                ++mBlockedProducers;
+                mDequeuePosition.wait(dequeuePosition);
+                --mBlockedProducers;
+                break;
+            case Backpressure::DropOldest:
+                if (auto dropped = tryPop())
+                {
+                    result = PushResult::PushedDroppingOldest;
+                    onDropped(std::move(*dropped));
+                }
+                break;
+            case Backpressure::FailFast:
+            default:
+                return PushResult::Rejected;
+            }
+        }
+    }
+
+    /// Only a snapshot, producers may push concurrently
+    bool empty() const
+    {
+        return mEnqueuePosition.load() == mDequeuePosition.load();
+    }
+
+    static constexpr std::size_t capacity()
+    {
+        return Capacity;
+    }
+
+private:
+    static constexpr std::size_t kMask = Capacity - 1;
+    // Keep the positions written by the producers and the consumer on separate
+    // cache lines so that they do not invalidate each other
+    static constexpr std::size_t kCacheLineSize = 64;
+
+    struct Slot
+    {
+        std::atomic<std::size_t> sequence;
+        alignas(T) std::byte storage[sizeof(T)];
+    };
+
+    alignas(kCacheLineSize) std::atomic<std::size_t> mEnqueuePosition{0};
+    alignas(kCacheLineSize) std::atomic<std::size_t> mDequeuePosition{0};
+    std::atomic<std::size_t> mBlockedProducers{0};
+    alignas(kCacheLineSize) std::array<Slot, Capacity> mSlots;
+};
+
+#endif // BREAKTHEDEPENDENCY_COMMANDRING_H
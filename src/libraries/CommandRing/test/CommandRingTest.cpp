@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "CommandRing.h"
+
+namespace
+{
+constexpr std::size_t kCapacity = 4;
+
+auto ignoreDropped = [](int) {};
+} // namespace
+
+struct CommandRingTest : public ::testing::Test
+{
+    void fill()
+    {
+        for (int command = 0; command < static_cast<int>(kCapacity); ++command)
+        {
+            ASSERT_TRUE(mCommandRing.tryPush(command));
+        }
+    }
+
+    CommandRing<int, kCapacity> mCommandRing;
+};
+
+TEST_F(CommandRingTest, tryPop_WhenEmpty_WillReturnNothing)
+{
+    EXPECT_FALSE(mCommandRing.tryPop());
+}
+
+TEST_F(CommandRingTest, tryPop_WhenPushed_WillReturnInPushOrder)
+{
+    fill();
+
+    for (int command = 0; command < static_cast<int>(kCapacity); ++command)
+    {
+        EXPECT_EQ(mCommandRing.tryPop(), command);
+    }
+    EXPECT_TRUE(mCommandRing.empty());
+}
+
+TEST_F(CommandRingTest, tryPush_WhenFull_WillFail)
+{
+    fill();
+    int command = 42;
+
+    EXPECT_FALSE(mCommandRing.tryPush(command));
+}
+
+TEST_F(CommandRingTest, push_WhenFullAndFailFast_WillReject)
+{
+    fill();
+    int command = 42;
+
+    EXPECT_EQ(mCommandRing.push(command, Backpressure::FailFast, ignoreDropped),
+              PushResult::Rejected);
+}
+
+TEST_F(CommandRingTest, push_WhenFullAndDropOldest_WillEvictOldest)
+{
+    fill();
+    int command = 42;
+    std::vector<int> dropped;
+
+    EXPECT_EQ(mCommandRing.push(command,
+                                Backpressure::DropOldest,
+                                [&dropped](int oldest) {
+                                    dropped.push_back(oldest);
+                                }),
+              PushResult::PushedDroppingOldest);
+    EXPECT_EQ(dropped, std::vector<int>{0});
+    EXPECT_EQ(mCommandRing.tryPop(), 1);
+}
+
+TEST_F(CommandRingTest, push_WhenFullAndBlock_WillWaitForConsumer)
+{
+    fill();
+    int command = 42;
+
+    std::thread consumer{[this] { mCommandRing.tryPop(); }};
+    EXPECT_EQ(mCommandRing.push(command, Backpressure::Block, ignoreDropped),
+              PushResult::Pushed);
+    consumer.join();
+}
+
+TEST(CommandRingConcurrencyTest, push_WhenManyProducers_WillDeliverEveryCommand)
+{
+    constexpr int kProducers           = 4;
+    constexpr int kCommandsPerProducer = 10000;
+    auto commandRing = std::make_unique<CommandRing<int, 64>>();
+
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < kProducers; ++producer)
+    {
+        producers.emplace_back([&commandRing, producer] {
+            for (int i = 0; i < kCommandsPerProducer; ++i)
+            {
+                int command = producer * kCommandsPerProducer + i;
+                commandRing->push(command, Backpressure::Block, ignoreDropped);
+            }
+        });
+    }
+
+    std::vector<int> lastSeen(kProducers, -1);
+    for (int received = 0; received < kProducers * kCommandsPerProducer;)
+    {
+        if (auto command = commandRing->tryPop())
+        {
+            const auto producer = *command / kCommandsPerProducer;
+            // Commands from the same producer must arrive in order
+            EXPECT_GT(*command, lastSeen[producer]);
+            lastSeen[producer] = *command;
+            ++received;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+}
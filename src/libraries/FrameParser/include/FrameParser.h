@@ -0,0 +1,172 @@
+#ifndef BREAKTHEDEPENDENCY_FRAMEPARSER_H
+#define BREAKTHEDEPENDENCY_FRAMEPARSER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <vector>
+
+/// How the frames are told apart in the stream of bytes
+enum class Framing
+{
+    Delimited,     // Every frame is terminated by a delimiter
+    LengthPrefixed // Every frame starts with a byte holding its length
+};
+
+/// Splits the bytes received from a device into frames as they arrive, in
+/// chunks of any size. A frame that lies within one chunk is handed out as a
+/// view into the chunk, only a frame that spans several chunks is gathered in
+/// the parser's buffer, which is allocated once on construction. Frames longer
+/// than the buffer are skipped and counted instead.
+class FrameParser
+{
+public:
+    /// The delimiter is not part of the frames handed out
+    static FrameParser delimited(char delimiter, std::size_t maxFrameSize)
+    {
+        return FrameParser{Framing::Delimited, delimiter, maxFrameSize};
+    }
+
+    /// The length prefix is not part of the frames handed out
+    static FrameParser lengthPrefixed(std::size_t maxFrameSize)
+    {
+        return FrameParser{Framing::LengthPrefixed, '\0', maxFrameSize};
+    }
+
+    /// Invokes `onFrame` with a std::string_view of every frame completed by
+    /// `bytes`. The view is only valid during the call.
+    template<typename FrameHandler>
+    void feed(std::span<const char> bytes, FrameHandler&& onFrame)
+    {
+        if (mFraming == Framing::Delimited)
+        {
+            feedDelimited(bytes, onFrame);
+        }
+        else
+        {
+            feedLengthPrefixed(bytes, onFrame);
+        }
+    }
+
+    /// Frames skipped for being longer than the maximum frame size
+    std::size_t skippedFrames() const
+    {
+        return mSkippedFrames;
+    }
+
+    /// Forgets a partially received frame, e.g. after reopening the device
+    void reset()
+    {
+        mFrameSize    = 0;
+        mExpectedSize = 0;
+        mHaveLength   = false;
+    }
+
+private:
+    FrameParser(Framing framing, char delimiter, std::size_t maxFrameSize)
+        : mFraming{framing}
+        , mDelimiter{delimiter}
+        , mBuffer(maxFrameSize)
+    {
+    }
+
+    template<typename FrameHandler>
+    void feedDelimited(std::span<const char> bytes, FrameHandler& onFrame)
+    {
+        while (!bytes.empty())
+        {
+            const auto* delimiter = static_cast<const char*>(
+                std::memchr(bytes.data(), mDelimiter, bytes.size()));
+            if (delimiter == nullptr)
+            {
+                gather(bytes);
+                return;
+            }
+
+            const auto frameEnd
+                = static_cast<std::size_t>(delimiter - bytes.data());
+            if (mFrameSize == 0 && frameEnd <= mBuffer.size())
+            {
+                onFrame(std::string_view{bytes.data(), frameEnd});
+            }
+            else
+            {
+                gather(bytes.first(frameEnd));
+                completeGathered(onFrame);
+            }
+            bytes = bytes.subspan(frameEnd + 1);
+        }
+    }
+
+    template<typename FrameHandler>
+    void feedLengthPrefixed(std::span<const char> bytes, FrameHandler& onFrame)
+    {
+        while (!bytes.empty())
+        {
+            if (!mHaveLength)
+            {
+                mExpectedSize = static_cast<unsigned char>(bytes.front());
+                mHaveLength   = true;
+                bytes         = bytes.subspan(1);
+            }
+
+            const auto missing
+                = std::min(mExpectedSize - mFrameSize, bytes.size());
+            if (mFrameSize == 0 && missing == mExpectedSize
+                && mExpectedSize <= mBuffer.size())
+            {
+                onFrame(std::string_view{bytes.data(), missing});
+                mHaveLength = false;
+            }
+            else
+            {
+                gather(bytes.first(missing));
+                if (mFrameSize == mExpectedSize)
+                {
+                    completeGathered(onFrame);
+                    mHaveLength = false;
+                }
+            }
+            bytes = bytes.subspan(missing);
+        }
+    }
+
+    /// Only copies what fits, the frame size keeps counting so that an
+    /// overlong frame is recognised once it is complete
+    void gather(std::span<const char> bytes)
+    {
+        if (mFrameSize < mBuffer.size())
+        {
+            std::memcpy(mBuffer.data() + mFrameSize,
+                        bytes.data(),
+                        std::min(bytes.size(), mBuffer.size() - mFrameSize));
+        }
+        mFrameSize += bytes.size();
+    }
+
+    template<typename FrameHandler>
+    void completeGathered(FrameHandler& onFrame)
+    {
+        if (mFrameSize <= mBuffer.size())
+        {
+            onFrame(std::string_view{mBuffer.data(), mFrameSize});
+        }
+        else
+        {
+            ++mSkippedFrames;
+        }
+        mFrameSize = 0;
+    }
+
+    Framing mFraming;
+    char mDelimiter;
+    std::vector<char> mBuffer;
+    std::size_t mFrameSize{0};
+    std::size_t mExpectedSize{0};
+    bool mHaveLength{false};
+    std::size_t mSkippedFrames{0};
+};
+
+#endif // BREAKTHEDEPENDENCY_FRAMEPARSER_H
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "FrameParser.h"
+
+using namespace std::literals;
+
+namespace
+{
+constexpr std::size_t kMaxFrameSize = 8;
+} // namespace
+
+struct FrameParserTest : public ::testing::Test
+{
+    void feed(FrameParser& frameParser, std::string_view bytes)
+    {
+        frameParser.feed(std::span{bytes.data(), bytes.size()},
+                         [this](std::string_view frame) {
+                             mFrames.emplace_back(frame);
+                         });
+    }
+
+    std::vector<std::string> mFrames;
+};
+
+TEST_F(FrameParserTest, feed_WhenDelimitedFramesInOneChunk_WillHandOutEach)
+{
+    auto frameParser = FrameParser::delimited('\n', kMaxFrameSize);
+
+    feed(frameParser, "ON\nOFF\n\n");
+
+    EXPECT_EQ(mFrames, (std::vector<std::string>{"ON", "OFF", ""}));
+}
+
+TEST_F(FrameParserTest, feed_WhenDelimitedFrameSplitAcrossChunks_WillJoinIt)
+{
+    auto frameParser = FrameParser::delimited('\n', kMaxFrameSize);
+
+    feed(frameParser, "O");
+    feed(frameParser, "F");
+    EXPECT_TRUE(mFrames.empty());
+    feed(frameParser, "F\nO");
+    feed(frameParser, "N\n");
+
+    EXPECT_EQ(mFrames, (std::vector<std::string>{"OFF", "ON"}));
+}
+
+TEST_F(FrameParserTest, feed_WhenDelimitedFrameTooLong_WillSkipIt)
+{
+    auto frameParser = FrameParser::delimited('\n', kMaxFrameSize);
+
+    feed(frameParser, "TELEMETRY\nON\n");
+    feed(frameParser, "TELE");
+    feed(frameParser, "METRY\nOFF\n");
+
+    EXPECT_EQ(mFrames, (std::vector<std::string>{"ON", "OFF"}));
+    EXPECT_EQ(frameParser.skippedFrames(), 2U);
+}
+
+TEST_F(FrameParserTest, feed_WhenLengthPrefixedFrames_WillHandOutEach)
+{
+    auto frameParser = FrameParser::lengthPrefixed(kMaxFrameSize);
+
+    feed(frameParser, "\x02ON\x03OFF\x00"sv);
+
+    EXPECT_EQ(mFrames, (std::vector<std::string>{"ON", "OFF", ""}));
+}
+
+TEST_F(FrameParserTest,
+       feed_WhenLengthPrefixedFrameSplitAcrossChunks_WillJoinIt)
+{
+    auto frameParser = FrameParser::lengthPrefixed(kMaxFrameSize);
+
+    feed(frameParser, "\x03");
+    feed(frameParser, "OF");
+    EXPECT_TRUE(mFrames.empty());
+    feed(frameParser, "F\x02O");
+    feed(frameParser, "N");
+
+    EXPECT_EQ(mFrames, (std::vector<std::string>{"OFF", "ON"}));
+}
+
+TEST_F(FrameParserTest, feed_WhenLengthPrefixedFrameTooLong_WillSkipIt)
+{
+    auto frameParser = FrameParser::lengthPrefixed(kMaxFrameSize);
+
+    feed(frameParser, "\x09TELEM");
+    feed(frameParser, "ETRY\x02ON");
+
+    EXPECT_EQ(mFrames, (std::vector<std::string>{"ON"}));
+    EXPECT_EQ(frameParser.skippedFrames(), 1U);
+}
+
+TEST_F(FrameParserTest, reset_WhenFrameIncomplete_WillDropIt)
+{
+    auto frameParser = FrameParser::delimited('\n', kMaxFrameSize);
+
+    feed(frameParser, "OF");
+    frameParser.reset();
+    feed(frameParser, "ON\n");
+
+    EXPECT_EQ(mFrames, (std::vector<std::string>{"ON"}));
+}
@@ -0,0 +1,41 @@
+#ifndef BREAKTHEDEPENDENCY_POSIXSERIALPORTMANAGER_H
+#define BREAKTHEDEPENDENCY_POSIXSERIALPORTMANAGER_H
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include "SerialMessage.h"
+
+/// Writes straight to the serial port's file descriptor on the caller's
+/// thread, for targets where the heap is off limits. Neither constructing
+/// the manager nor writing to it allocates, so it can be placed in static
+/// storage or in an arena, e.g. as part of a CameraPowerController that
+/// keeps its manager in place. Only failures allocate, to report them.
+class PosixSerialPortManager
+{
+public:
+    static constexpr std::size_t kMaxSerialDeviceLength = 63;
+
+    /// Does not touch the device, it is opened by the first write. Throws
+    /// std::length_error for devices longer than kMaxSerialDeviceLength.
+    PosixSerialPortManager(std::string_view serialDevice, int baudRate);
+    ~PosixSerialPortManager();
+
+    PosixSerialPortManager(const PosixSerialPortManager&)            = delete;
+    PosixSerialPortManager& operator=(const PosixSerialPortManager&) = delete;
+
+    /// Blocks until the message has been written, throws std::system_error
+    /// on failure. Named after the write the controllers expect.
+    void asioWrite(SerialMessage message);
+
+private:
+    void openIfNeeded();
+
+    // Null terminated, as open() expects
+    std::array<char, kMaxSerialDeviceLength + 1> mSerialDevice{};
+    int mBaudRate;
+    int mFileDescriptor{-1};
+};
+
+#endif // BREAKTHEDEPENDENCY_POSIXSERIALPORTMANAGER_H
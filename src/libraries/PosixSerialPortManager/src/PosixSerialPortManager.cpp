@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "PosixSerialPortManager.h"
+
+namespace
+{
+[[noreturn]] void throwLastSystemError(const char* what)
+{
+    throw std::system_error{errno, std::system_category(), what};
+}
+
+speed_t speedFor(int baudRate)
+{
+    switch (baudRate)
+    {
+    case 1200:
+        return B1200;
+    case 2400:
+        return B2400;
+    case 4800:
+        return B4800;
+    case 9600:
+        return B9600;
+    case 19200:
+        return B19200;
+    case 38400:
+        return B38400;
+    case 57600:
+        return B57600;
+    case 115200:
+        return B115200;
+    case 230400:
+        return B230400;
+#ifdef B460800
+    case 460800:
+        return B460800;
+#endif
+#ifdef B921600
+    case 921600:
+        return B921600;
+#endif
+    default:
+        throw std::system_error{
+            std::make_error_code(std::errc::invalid_argument),
+            "Unsupported baud rate"};
+    }
+}
+} // namespace
+
+PosixSerialPortManager::PosixSerialPortManager(std::string_view serialDevice,
+                                               int baudRate)
+    : mBaudRate{baudRate}
+{
+    if (serialDevice.size() > kMaxSerialDeviceLength)
+    {
+        throw std::length_error("Serial device path too long");
+    }
+    std::copy(serialDevice.begin(), serialDevice.end(), mSerialDevice.begin());
+}
+
+PosixSerialPortManager::~PosixSerialPortManager()
+{
+    if (mFileDescriptor != -1)
+    {
+        ::close(mFileDescriptor);
+    }
+}
+
+void PosixSerialPortManager::asioWrite(SerialMessage message)
+{
+    openIfNeeded();
+
+    const auto* remaining = message.data();
+    auto remainingBytes   = message.size();
+    while (remainingBytes > 0)
+    {
+        const auto written
+            = ::write(mFileDescriptor, remaining, remainingBytes);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throwLastSystemError("write");
+        }
+
+        remaining += written;
+        remainingBytes -= static_cast<std::size_t>(written);
+    }
+}
+
+void PosixSerialPortManager::openIfNeeded()
+{
+    if (mFileDescriptor != -1)
+    {
+        return;
+    }
+
+    const auto speed = speedFor(mBaudRate);
+    const auto fileDescriptor
+        = ::open(mSerialDevice.data(), O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (fileDescriptor == -1)
+    {
+        throwLastSystemError("open");
+    }
+
+    termios attributes{};
+    if (::tcgetattr(fileDescriptor, &attributes) != 0)
+    {
+        const auto error = errno;
+        ::close(fileDescriptor);
+        throw std::system_error{error, std::system_category(), "tcgetattr"};
+    }
+    ::cfmakeraw(&attributes);
+    ::cfsetispeed(&attributes, speed);
+    ::cfsetospeed(&attributes, speed);
+    if (::tcsetattr(fileDescriptor, TCSANOW, &attributes) != 0)
+    {
+        const auto error = errno;
+        ::close(fileDescriptor);
+        throw std::system_error{error, std::system_category(), "tcsetattr"};
+    }
+
+    mFileDescriptor = fileDescriptor;
+}
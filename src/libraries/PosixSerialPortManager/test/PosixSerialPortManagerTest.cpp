@@ -0,0 +1,65 @@
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include "gtest/gtest.h"
+
+#include "HeapGuard.h"
+#include "PosixSerialPortManager.h"
+#include "SimulatedSerialDeviceFixture.h"
+
+namespace
+{
+const auto kBaudRate = 9600;
+} // namespace
+
+struct PosixSerialPortManagerTest : public SimulatedSerialDeviceFixture
+{
+};
+
+TEST_F(PosixSerialPortManagerTest, asioWrite_WhenCalled_WillWriteMessages)
+{
+    PosixSerialPortManager posixSerialPortManager{mSerialDevice.native(),
+                                                  kBaudRate};
+
+    posixSerialPortManager.asioWrite("ON");
+    posixSerialPortManager.asioWrite("OFF");
+
+    ASSERT_TRUE(mSimulatedSerialDevice.waitForBytesFromHost(5));
+    EXPECT_EQ(mSimulatedSerialDevice.received(), "ONOFF");
+}
+
+TEST_F(PosixSerialPortManagerTest,
+       asioWrite_WhenHeapForbidden_WillNotAllocateFromConstructionOn)
+{
+    {
+        HeapGuard heapGuard;
+        PosixSerialPortManager posixSerialPortManager{mSerialDevice.native(),
+                                                      kBaudRate};
+        posixSerialPortManager.asioWrite("ON");
+        posixSerialPortManager.asioWrite("OFF");
+    }
+
+    EXPECT_EQ(HeapGuard::refusedAllocations(), 0U);
+    ASSERT_TRUE(mSimulatedSerialDevice.waitForBytesFromHost(5));
+    EXPECT_EQ(mSimulatedSerialDevice.received(), "ONOFF");
+}
+
+TEST(PosixSerialPortManagerWithoutDeviceTest,
+     asioWrite_WhenDeviceMissing_WillThrow)
+{
+    PosixSerialPortManager posixSerialPortManager{
+        "/dev/NoSuchCoolCompanyDevice", kBaudRate};
+
+    EXPECT_THROW(posixSerialPortManager.asioWrite("ON"), std::system_error);
+}
+
+TEST(PosixSerialPortManagerWithoutDeviceTest,
+     constructor_WhenDeviceTooLong_WillThrow)
+{
+    const std::string serialDevice(
+        PosixSerialPortManager::kMaxSerialDeviceLength + 1, 'x');
+
+    EXPECT_THROW((PosixSerialPortManager{serialDevice, kBaudRate}),
+                 std::length_error);
+}
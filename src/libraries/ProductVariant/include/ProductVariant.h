@@ -4,7 +4,8 @@
 enum class ProductVariant
 {
     A,
-    B
+    B,
+    C
 };
 
 #endif // BREAKTHEDEPENDENCY_PRODUCTVARIANT_H
@@ -0,0 +1,67 @@
+#ifndef BREAKTHEDEPENDENCY_PRODUCTVARIANTTRAITS_H
+#define BREAKTHEDEPENDENCY_PRODUCTVARIANTTRAITS_H
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include "ProductVariant.h"
+#include "WireProtocol.h"
+
+struct ProductVariantTraits
+{
+    ProductVariant productVariant;
+    std::string_view serialDevice;
+    int baudRate;
+    WireProtocol wireProtocol;
+    /// Only sent with WireProtocol::CompactBinary
+    std::uint8_t busAddress;
+};
+
+/// One entry per variant, nothing else needs to change to add one
+inline constexpr std::array kProductVariantTraits{
+    ProductVariantTraits{ProductVariant::A,
+                         "/dev/CoolCompanyDevice",
+                         9600,
+                         WireProtocol::Ascii,
+                         0},
+    ProductVariantTraits{
+        ProductVariant::B, "COM3", 115200, WireProtocol::Ascii, 0},
+    ProductVariantTraits{ProductVariant::C,
+                         "/dev/CoolCompanyBus",
+                         9600,
+                         WireProtocol::CompactBinary,
+                         1},
+};
+
+/// Throws std::logic_error for variants missing from the table, which fails
+/// the compilation when evaluated at compile time
+constexpr const ProductVariantTraits&
+getProductVariantTraits(ProductVariant productVariant)
+{
+    for (const auto& traits : kProductVariantTraits)
+    {
+        if (traits.productVariant == productVariant)
+        {
+            return traits;
+        }
+    }
+
+    throw std::logic_error("Unknown variant");
+}
+
+template<ProductVariant productVariant>
+inline constexpr const ProductVariantTraits& kProductVariantTraitsFor
+    = getProductVariantTraits(productVariant);
+
+/// Selects the constructors that resolve the variant at compile time
+template<ProductVariant productVariant>
+using ProductVariantConstant
+    = std::integral_constant<ProductVariant, productVariant>;
+
+template<ProductVariant productVariant>
+inline constexpr ProductVariantConstant<productVariant> kProductVariant{};
+
+#endif // BREAKTHEDEPENDENCY_PRODUCTVARIANTTRAITS_H
@@ -0,0 +1,13 @@
+#ifndef BREAKTHEDEPENDENCY_WIREPROTOCOL_H
+#define BREAKTHEDEPENDENCY_WIREPROTOCOL_H
+
+/// How camera commands are encoded on the wire
+enum class WireProtocol
+{
+    /// Plain "ON" and "OFF" strings
+    Ascii,
+    /// Three bytes: opcode, bus address and checksum
+    CompactBinary
+};
+
+#endif // BREAKTHEDEPENDENCY_WIREPROTOCOL_H
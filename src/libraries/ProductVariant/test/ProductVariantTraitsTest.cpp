@@ -0,0 +1,52 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+
+#include "ProductVariantTraits.h"
+
+using namespace std::literals;
+
+static_assert(kProductVariantTraitsFor<ProductVariant::A>.serialDevice
+              == "/dev/CoolCompanyDevice"sv);
+static_assert(kProductVariantTraitsFor<ProductVariant::A>.baudRate == 9600);
+static_assert(kProductVariantTraitsFor<ProductVariant::B>.serialDevice
+              == "COM3"sv);
+static_assert(kProductVariantTraitsFor<ProductVariant::B>.baudRate == 115200);
+static_assert(kProductVariantTraitsFor<ProductVariant::A>.wireProtocol
+              == WireProtocol::Ascii);
+static_assert(kProductVariantTraitsFor<ProductVariant::B>.wireProtocol
+              == WireProtocol::Ascii);
+static_assert(kProductVariantTraitsFor<ProductVariant::C>.wireProtocol
+              == WireProtocol::CompactBinary);
+static_assert(kProductVariantTraitsFor<ProductVariant::C>.busAddress == 1);
+
+TEST(ProductVariantTraitsTest,
+     getProductVariantTraits_WhenKnownVariant_WillReturnItsEntry)
+{
+    for (const auto& traits : kProductVariantTraits)
+    {
+        EXPECT_EQ(&getProductVariantTraits(traits.productVariant), &traits);
+    }
+}
+
+TEST(ProductVariantTraitsTest,
+     getProductVariantTraits_WhenUnknownVariant_WillThrow)
+{
+    EXPECT_THROW(getProductVariantTraits(static_cast<ProductVariant>(51323)),
+                 std::logic_error);
+}
+
+TEST(ProductVariantTraitsTest, kProductVariantTraits_WillHaveOneEntryPerVariant)
+{
+    for (const auto& traits : kProductVariantTraits)
+    {
+        EXPECT_EQ(std::count_if(kProductVariantTraits.begin(),
+                                kProductVariantTraits.end(),
+                                [&traits](const auto& other) {
+                                    return other.productVariant
+                                           == traits.productVariant;
+                                }),
+                  1);
+    }
+}
@@ -0,0 +1,97 @@
+#ifndef BREAKTHEDEPENDENCY_REQUESTPIPELINE_H
+#define BREAKTHEDEPENDENCY_REQUESTPIPELINE_H
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include "AsioSerialPortManager.h"
+#include "SerialMessage.h"
+
+struct RequestPolicy
+{
+    /// Requests written without waiting for the earlier ones to be answered.
+    /// At most 128, which leaves enough sequence numbers to rest while a
+    /// late response to their previous request may still arrive.
+    std::size_t window{8};
+    /// How long a written request waits for its response
+    std::chrono::steady_clock::duration timeout{std::chrono::milliseconds{250}};
+    /// Times an unanswered request is written again before giving up
+    std::size_t maxRetransmits{2};
+    /// Longer responses are skipped
+    std::size_t maxResponseSize{64};
+};
+
+/// Keeps several requests to a device in flight on one serial port instead of
+/// waiting for every response before writing the next request. Each request
+/// is tagged with a sequence number that the device repeats in its response,
+/// so responses are matched to their requests in whatever order they arrive.
+/// Requests are written as "<sequence>#<payload>\n" and responses are expected
+/// as "<sequence>#<response>\n", the sequence number counting up from 0 to 255
+/// and wrapping around. A request that is not answered in time is written
+/// again under the same sequence number. Numbers still held by an outstanding
+/// request are skipped, and so are those of requests that were retransmitted
+/// or given up on for timeout * (maxRetransmits + 1), so that a late response
+/// is never mistaken for the response to a newer request.
+/// The bookkeeping and the timers run on the manager's I/O service, which has
+/// to be running for requests to make progress. The pipeline owns the
+/// manager's frame handler while it lives, so constructing it on a manager
+/// whose frames are already handled throws std::logic_error, see
+/// AsioSerialPortManager::setFrameHandler().
+class RequestPipeline
+{
+public:
+    using ResponseHandler
+        = std::function<void(std::error_code error, std::string_view response)>;
+
+    explicit RequestPipeline(AsioSerialPortManager& asioSerialPortManager,
+                             RequestPolicy requestPolicy = {});
+    /// Requests that are still outstanding complete with
+    /// `asio::error::operation_aborted`
+    ~RequestPipeline();
+
+    RequestPipeline(const RequestPipeline&) = delete;
+    RequestPipeline& operator=(const RequestPipeline&) = delete;
+
+    /// Safe to call from any thread. `onResponse` is invoked on the thread
+    /// running the manager's I/O service, either with the response, which is
+    /// only valid during the call, with `asio::error::timed_out` once every
+    /// retransmit went unanswered or with the error of a failed write.
+    void asyncRequest(SerialMessage payload, ResponseHandler onResponse);
+
+    /// Completes through an asio completion token with the response, e.g.
+    /// `co_await requestPipeline.asyncRequest(payload, asio::use_awaitable)`
+    template<typename CompletionToken>
+    requires(!std::is_convertible_v<CompletionToken, ResponseHandler>)
+    auto asyncRequest(SerialMessage payload, CompletionToken&& token)
+    {
+        return asio::async_initiate<CompletionToken,
+                                    void(std::error_code, std::string)>(
+            [this](auto handler, SerialMessage queuedPayload) {
+                asyncRequest(
+                    std::move(queuedPayload),
+                    [onResponse = postToAssociatedExecutor(std::move(handler))](
+                        std::error_code error,
+                        std::string_view response) mutable {
+                        onResponse(error, std::string{response});
+                    });
+            },
+            token,
+            std::move(payload));
+    }
+
+private:
+    class Window;
+
+    // Shared with the handlers pending on the I/O service, which may still
+    // run after the pipeline is gone
+    std::shared_ptr<Window> mWindow;
+};
+
+#endif // BREAKTHEDEPENDENCY_REQUESTPIPELINE_H
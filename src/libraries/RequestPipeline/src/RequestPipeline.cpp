@@ -0,0 +1,352 @@
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "FrameParser.h"
+#include "RequestPipeline.h"
+
+namespace
+{
+constexpr auto kFrameDelimiter               = '\n';
+constexpr auto kSequenceSeparator            = '#';
+constexpr std::size_t kMaxWindow             = 128;
+constexpr std::size_t kSequences             = 256;
+constexpr std::size_t kMaxSequencePrefixSize = 4; // "255#"
+} // namespace
+
+class RequestPipeline::Window : public std::enable_shared_from_this<Window>
+{
+public:
+    Window(AsioSerialPortManager& asioSerialPortManager,
+           RequestPolicy requestPolicy)
+        : mAsioSerialPortManager{asioSerialPortManager}
+        , mRequestPolicy{requestPolicy}
+        , mRetirement{mRequestPolicy.timeout
+                      * static_cast<std::chrono::steady_clock::rep>(
+                          mRequestPolicy.maxRetransmits + 1)}
+        , mSequenceTimer{mAsioSerialPortManager.executor()}
+    {
+        // Reserved up front since the timers of the slots are in use by
+        // pending operations and must never be moved
+        mSlots.reserve(mRequestPolicy.window);
+        for (std::size_t slot = 0; slot < mRequestPolicy.window; ++slot)
+        {
+            mSlots.emplace_back(mAsioSerialPortManager.executor());
+        }
+    }
+
+    AsioSerialPortManager::Executor executor()
+    {
+        return mAsioSerialPortManager.executor();
+    }
+
+    void listen()
+    {
+        mAsioSerialPortManager.setFrameHandler(
+            FrameParser::delimited(kFrameDelimiter,
+                                   kMaxSequencePrefixSize
+                                       + mRequestPolicy.maxResponseSize),
+            [self = shared_from_this()](std::string_view frame) {
+                self->onFrame(frame);
+            });
+    }
+
+    /// Called on the caller's thread, so that another pipeline can take over
+    /// the frames as soon as this one is gone
+    void stopListening()
+    {
+        mAsioSerialPortManager.setFrameHandler(
+            FrameParser::delimited(kFrameDelimiter, kMaxSequencePrefixSize),
+            {});
+    }
+
+    void submit(SerialMessage payload, ResponseHandler onResponse)
+    {
+        if (mClosed)
+        {
+            onResponse(asio::error::operation_aborted, {});
+            return;
+        }
+
+        mWaiting.push_back({std::move(payload), std::move(onResponse)});
+        sendWaiting();
+    }
+
+    void close()
+    {
+        mClosed = true;
+        mSequenceTimer.cancel();
+        for (auto& slot : mSlots)
+        {
+            if (slot.sequence)
+            {
+                complete(slot, asio::error::operation_aborted, {});
+            }
+        }
+        for (auto& request : std::exchange(mWaiting, {}))
+        {
+            request.onResponse(asio::error::operation_aborted, {});
+        }
+    }
+
+private:
+    struct Request
+    {
+        SerialMessage payload;
+        ResponseHandler onResponse;
+    };
+
+    struct Slot
+    {
+        explicit Slot(AsioSerialPortManager::Executor executor)
+            : timer{executor}
+        {
+        }
+
+        asio::steady_timer timer;
+        std::optional<std::uint8_t> sequence;
+        SerialMessage frame{""};
+        ResponseHandler onResponse;
+        std::size_t retransmits{0};
+        // Tells the handlers of an earlier transmission apart, whose timer
+        // may have expired just before the slot was completed
+        std::uint64_t transmission{0};
+    };
+
+    void sendWaiting()
+    {
+        for (auto& slot : mSlots)
+        {
+            if (mWaiting.empty())
+            {
+                return;
+            }
+            if (slot.sequence)
+            {
+                continue;
+            }
+
+            const auto sequence = takeSequence();
+            if (!sequence)
+            {
+                waitForRetiredSequence();
+                return;
+            }
+
+            auto request = std::move(mWaiting.front());
+            mWaiting.pop_front();
+            const auto payload = request.payload.view();
+            slot.sequence      = sequence;
+            slot.frame          = SerialMessage::copyOf(
+                std::to_string(unsigned{*sequence}) + kSequenceSeparator
+                + std::string{payload} + kFrameDelimiter);
+            slot.onResponse  = std::move(request.onResponse);
+            slot.retransmits = 0;
+            transmit(slot);
+        }
+    }
+
+    /// The next sequence number that is neither held by an outstanding
+    /// request nor retired too recently for a late response to its last
+    /// request to be ruled out
+    std::optional<std::uint8_t> takeSequence()
+    {
+        const auto now = std::chrono::steady_clock::now();
+        for (std::size_t candidate = 0; candidate < kSequences; ++candidate)
+        {
+            const auto sequence
+                = static_cast<std::uint8_t>(mNextSequence + candidate);
+            const auto outstanding = std::any_of(
+                mSlots.begin(), mSlots.end(), [sequence](const Slot& slot) {
+                    return slot.sequence == sequence;
+                });
+            if (outstanding || now < mRetiredUntil[sequence])
+            {
+                continue;
+            }
+
+            mNextSequence = static_cast<std::uint8_t>(sequence + 1);
+            return sequence;
+        }
+        return std::nullopt;
+    }
+
+    void waitForRetiredSequence()
+    {
+        const auto now = std::chrono::steady_clock::now();
+        auto earliest  = std::chrono::steady_clock::time_point::max();
+        for (const auto retiredUntil : mRetiredUntil)
+        {
+            if (retiredUntil > now)
+            {
+                earliest = std::min(earliest, retiredUntil);
+            }
+        }
+
+        mSequenceTimer.expires_at(earliest);
+        mSequenceTimer.async_wait(
+            [self = shared_from_this()](std::error_code timerError) {
+                if (!timerError && !self->mClosed)
+                {
+                    self->sendWaiting();
+                }
+            });
+    }
+
+    void transmit(Slot& slot)
+    {
+        const auto transmission = ++slot.transmission;
+        // The timeout only starts once the request has left the serial port,
+        // which can take a while behind the other requests of the window
+        const auto queued = mAsioSerialPortManager.asyncWrite(
+            slot.frame,
+            [self = shared_from_this(), &slot, transmission](
+                std::error_code error, std::size_t) {
+                self->onWritten(slot, transmission, error);
+            });
+        if (!queued)
+        {
+            complete(slot, asio::error::no_buffer_space, {});
+        }
+    }
+
+    void onWritten(Slot& slot,
+                   std::uint64_t transmission,
+                   std::error_code error)
+    {
+        if (slot.transmission != transmission || !slot.sequence)
+        {
+            return;
+        }
+        if (error)
+        {
+            complete(slot, error, {});
+            return;
+        }
+
+        slot.timer.expires_after(mRequestPolicy.timeout);
+        slot.timer.async_wait(
+            [self = shared_from_this(), &slot, transmission](
+                std::error_code timerError) {
+                if (!timerError)
+                {
+                    self->onTimeout(slot, transmission);
+                }
+            });
+    }
+
+    void onTimeout(Slot& slot, std::uint64_t transmission)
+    {
+        if (slot.transmission != transmission || !slot.sequence)
+        {
+            return;
+        }
+        if (slot.retransmits == mRequestPolicy.maxRetransmits)
+        {
+            complete(slot, asio::error::timed_out, {});
+            return;
+        }
+
+        ++slot.retransmits;
+        transmit(slot);
+    }
+
+    void onFrame(std::string_view frame)
+    {
+        const auto separator = frame.find(kSequenceSeparator);
+        if (separator == std::string_view::npos)
+        {
+            return;
+        }
+
+        std::uint8_t sequence = 0;
+        const auto [end, error]
+            = std::from_chars(frame.data(), frame.data() + separator, sequence);
+        if (error != std::errc{} || end != frame.data() + separator)
+        {
+            return;
+        }
+
+        // A response to a request that is no longer outstanding, e.g. the
+        // second response to a retransmitted request, is ignored
+        for (auto& slot : mSlots)
+        {
+            if (slot.sequence == sequence)
+            {
+                complete(slot, {}, frame.substr(separator + 1));
+                return;
+            }
+        }
+    }
+
+    void complete(Slot& slot, std::error_code error, std::string_view response)
+    {
+        ++slot.transmission;
+        slot.timer.cancel();
+        // A request that was written more than once or given up on may still
+        // be answered, possibly several times
+        if (error || slot.retransmits > 0)
+        {
+            mRetiredUntil[*slot.sequence]
+                = std::chrono::steady_clock::now() + mRetirement;
+        }
+        slot.sequence.reset();
+        slot.frame = "";
+        auto onResponse = std::exchange(slot.onResponse, {});
+        onResponse(error, response);
+        if (!mClosed)
+        {
+            sendWaiting();
+        }
+    }
+
+    AsioSerialPortManager& mAsioSerialPortManager;
+    RequestPolicy mRequestPolicy;
+    // How long after its last transmission a request can still be answered
+    std::chrono::steady_clock::duration mRetirement;
+    std::deque<Request> mWaiting;
+    std::vector<Slot> mSlots;
+    std::uint8_t mNextSequence{0};
+    std::array<std::chrono::steady_clock::time_point, kSequences>
+        mRetiredUntil{};
+    // Retries the waiting requests once every free sequence number has
+    // served its retirement
+    asio::steady_timer mSequenceTimer;
+    bool mClosed{false};
+};
+
+RequestPipeline::RequestPipeline(AsioSerialPortManager& asioSerialPortManager,
+                                 RequestPolicy requestPolicy)
+{
+    if (requestPolicy.window == 0 || requestPolicy.window > kMaxWindow)
+    {
+        throw std::invalid_argument("Window must hold 1 to 128 requests");
+    }
+
+    mWindow = std::make_shared<Window>(asioSerialPortManager, requestPolicy);
+    mWindow->listen();
+}
+
+RequestPipeline::~RequestPipeline()
+{
+    mWindow->stopListening();
+    asio::post(mWindow->executor(), [window = mWindow] { window->close(); });
+}
+
+void RequestPipeline::asyncRequest(SerialMessage payload,
+                                   ResponseHandler onResponse)
+{
+    asio::post(mWindow->executor(),
+               [window     = mWindow,
+                payload    = std::move(payload),
+                onResponse = std::move(onResponse)]() mutable {
+                   window->submit(std::move(payload), std::move(onResponse));
+               });
+}
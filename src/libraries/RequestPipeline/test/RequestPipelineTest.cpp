@@ -0,0 +1,318 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "FrameParser.h"
+#include "RequestPipeline.h"
+#include "SimulatedSerialDevice.h"
+
+using namespace std::literals;
+
+namespace
+{
+const auto kBaudRate = 9600;
+
+struct Response
+{
+    std::error_code error;
+    std::string response;
+};
+} // namespace
+
+/// Answers every request "<sequence>#<payload>" with "<sequence>#ACK <payload>"
+/// unless it is told to stay silent or to answer pairs of requests in reverse.
+/// Requests for "LOST" are never answered.
+struct Responder
+{
+    void operator()(std::string_view bytes,
+                    std::chrono::steady_clock::time_point)
+    {
+        mFrameParser.feed(std::span{bytes.data(), bytes.size()},
+                          [this](std::string_view request) {
+                              respondTo(request);
+                          });
+    }
+
+    void respondTo(std::string_view request)
+    {
+        ++mRequests;
+        const auto separator = request.find('#');
+        if (mSilent || request.substr(separator + 1) == "LOST")
+        {
+            return;
+        }
+
+        auto response        = std::string{request.substr(0, separator + 1)}
+                        + "ACK " + std::string{request.substr(separator + 1)}
+                        + "\n";
+        if (!mReversePairs)
+        {
+            mSimulatedSerialDevice->sendToHost(response);
+        }
+        else if (mHeldBack.empty())
+        {
+            mHeldBack = response;
+        }
+        else
+        {
+            mSimulatedSerialDevice->sendToHost(response + mHeldBack);
+            mHeldBack.clear();
+        }
+    }
+
+    SimulatedSerialDevice* mSimulatedSerialDevice{nullptr};
+    FrameParser mFrameParser{FrameParser::delimited('\n', 64)};
+    std::atomic<std::size_t> mRequests{0};
+    std::atomic<bool> mSilent{false};
+    std::atomic<bool> mReversePairs{false};
+    std::string mHeldBack;
+};
+
+struct RequestPipelineTest : public ::testing::Test
+{
+    RequestPipelineTest()
+        : RequestPipelineTest{{}}
+    {
+    }
+
+    explicit RequestPipelineTest(SimulatedSerialDevice::Behaviour behaviour)
+        : mSimulatedSerialDevice{behaviour, std::ref(mResponder)}
+    {
+        mResponder.mSimulatedSerialDevice = &mSimulatedSerialDevice;
+        mAsioSerialPortManager.start();
+    }
+
+    ~RequestPipelineTest() override
+    {
+        mAsioSerialPortManager.stop();
+    }
+
+    void request(RequestPipeline& requestPipeline, std::string payload)
+    {
+        requestPipeline.asyncRequest(
+            SerialMessage::copyOf(payload),
+            [this](std::error_code error, std::string_view response) {
+                std::lock_guard lock{mResponsesMutex};
+                mResponses.push_back({error, std::string{response}});
+                mResponseReceived.notify_all();
+            });
+    }
+
+    bool waitForResponses(std::size_t responses)
+    {
+        std::unique_lock lock{mResponsesMutex};
+        return mResponseReceived.wait_for(lock, 10s, [this, responses] {
+            return mResponses.size() >= responses;
+        });
+    }
+
+    Responder mResponder;
+    SimulatedSerialDevice mSimulatedSerialDevice;
+    AsioSerialPortManager mAsioSerialPortManager{
+        mSimulatedSerialDevice.serialDevice(), kBaudRate};
+    std::mutex mResponsesMutex;
+    std::condition_variable mResponseReceived;
+    std::vector<Response> mResponses;
+};
+
+TEST_F(RequestPipelineTest,
+       asyncRequest_WhenDeviceResponds_WillCompleteWithResponse)
+{
+    RequestPipeline requestPipeline{mAsioSerialPortManager};
+
+    for (auto request = 0; request < 20; ++request)
+    {
+        this->request(requestPipeline, "CAM" + std::to_string(request));
+    }
+
+    ASSERT_TRUE(waitForResponses(20));
+    for (auto request = 0; request < 20; ++request)
+    {
+        EXPECT_FALSE(mResponses[static_cast<std::size_t>(request)].error);
+        EXPECT_EQ(mResponses[static_cast<std::size_t>(request)].response,
+                  "ACK CAM" + std::to_string(request));
+    }
+}
+
+TEST_F(RequestPipelineTest,
+       asyncRequest_WhenResponsesOutOfOrder_WillMatchThemBySequence)
+{
+    mResponder.mReversePairs = true;
+    RequestPipeline requestPipeline{mAsioSerialPortManager};
+
+    request(requestPipeline, "ON");
+    request(requestPipeline, "OFF");
+
+    ASSERT_TRUE(waitForResponses(2));
+    EXPECT_EQ(mResponses[0].response, "ACK OFF");
+    EXPECT_EQ(mResponses[1].response, "ACK ON");
+}
+
+TEST_F(RequestPipelineTest,
+       asyncRequest_WhenDeviceSilent_WillRetransmitThenTimeOut)
+{
+    mResponder.mSilent = true;
+    RequestPolicy requestPolicy;
+    requestPolicy.timeout        = 20ms;
+    requestPolicy.maxRetransmits = 2;
+    RequestPipeline requestPipeline{mAsioSerialPortManager, requestPolicy};
+
+    request(requestPipeline, "ON");
+
+    ASSERT_TRUE(waitForResponses(1));
+    EXPECT_EQ(mResponses[0].error, asio::error::timed_out);
+    EXPECT_EQ(mResponder.mRequests, 3U);
+    EXPECT_EQ(mSimulatedSerialDevice.received(), "0#ON\n0#ON\n0#ON\n");
+}
+
+TEST_F(RequestPipelineTest,
+       asyncRequest_WhenWindowFull_WillHoldBackFurtherRequests)
+{
+    mResponder.mSilent = true;
+    RequestPolicy requestPolicy;
+    requestPolicy.window  = 4;
+    requestPolicy.timeout = 10s;
+    RequestPipeline requestPipeline{mAsioSerialPortManager, requestPolicy};
+
+    for (auto request = 0; request < 10; ++request)
+    {
+        this->request(requestPipeline, "ON");
+    }
+
+    ASSERT_TRUE(mSimulatedSerialDevice.waitForBytesFromHost(20));
+    std::this_thread::sleep_for(50ms);
+    EXPECT_EQ(mResponder.mRequests, 4U);
+}
+
+TEST_F(RequestPipelineTest,
+       destructor_WhenRequestsOutstanding_WillAbortThem)
+{
+    mResponder.mSilent = true;
+    {
+        RequestPolicy requestPolicy;
+        requestPolicy.window  = 1;
+        requestPolicy.timeout = 10s;
+        RequestPipeline requestPipeline{mAsioSerialPortManager, requestPolicy};
+        request(requestPipeline, "ON");
+        request(requestPipeline, "OFF");
+    }
+
+    ASSERT_TRUE(waitForResponses(2));
+    EXPECT_EQ(mResponses[0].error, asio::error::operation_aborted);
+    EXPECT_EQ(mResponses[1].error, asio::error::operation_aborted);
+}
+
+TEST_F(RequestPipelineTest,
+       asyncRequest_WhenSequenceWrapsAround_WillSkipTheOutstandingOne)
+{
+    RequestPolicy requestPolicy;
+    requestPolicy.window  = 2;
+    requestPolicy.timeout = 10s;
+    RequestPipeline requestPipeline{mAsioSerialPortManager, requestPolicy};
+
+    request(requestPipeline, "LOST");
+    for (auto request = 0; request < 256; ++request)
+    {
+        this->request(requestPipeline, "CAM" + std::to_string(request));
+    }
+
+    ASSERT_TRUE(waitForResponses(256));
+    EXPECT_EQ(mResponses.back().response, "ACK CAM255");
+    EXPECT_NE(mSimulatedSerialDevice.received().find("\n1#CAM255\n"),
+              std::string::npos);
+}
+
+TEST_F(RequestPipelineTest,
+       asyncRequest_WhenSequenceTimedOutRecently_WillNotReuseIt)
+{
+    RequestPolicy requestPolicy;
+    requestPolicy.window         = 1;
+    requestPolicy.timeout        = 500ms;
+    requestPolicy.maxRetransmits = 0;
+    RequestPipeline requestPipeline{mAsioSerialPortManager, requestPolicy};
+    // The device takes the requests in faster than the port's baud rate, so
+    // that they all fit into the retirement of the one that timed out
+    mAsioSerialPortManager.setBatchingPolicy(
+        {{}, 512, std::numeric_limits<std::size_t>::max()});
+
+    request(requestPipeline, "LOST");
+    ASSERT_TRUE(waitForResponses(1));
+    for (auto request = 0; request < 256; ++request)
+    {
+        this->request(requestPipeline, "CAM" + std::to_string(request));
+    }
+
+    ASSERT_TRUE(waitForResponses(257));
+    EXPECT_EQ(mResponses.front().error, asio::error::timed_out);
+    EXPECT_NE(mSimulatedSerialDevice.received().find("\n1#CAM255\n"),
+              std::string::npos);
+}
+
+TEST_F(RequestPipelineTest,
+       constructor_WhenManagerFramesAlreadyHandled_WillThrow)
+{
+    RequestPipeline requestPipeline{mAsioSerialPortManager};
+
+    EXPECT_THROW(RequestPipeline{mAsioSerialPortManager}, std::logic_error);
+}
+
+TEST_F(RequestPipelineTest,
+       constructor_WhenPreviousPipelineGone_WillTakeOverTheFrames)
+{
+    {
+        RequestPipeline requestPipeline{mAsioSerialPortManager};
+    }
+    RequestPipeline requestPipeline{mAsioSerialPortManager};
+
+    request(requestPipeline, "ON");
+
+    ASSERT_TRUE(waitForResponses(1));
+    EXPECT_EQ(mResponses[0].response, "ACK ON");
+}
+
+struct LossyRequestPipelineTest : public RequestPipelineTest
+{
+    static SimulatedSerialDevice::Behaviour lossy()
+    {
+        SimulatedSerialDevice::Behaviour behaviour;
+        behaviour.dropProbability = 0.2;
+        behaviour.frameDelimiter  = '\n';
+        return behaviour;
+    }
+
+    LossyRequestPipelineTest()
+        : RequestPipelineTest{lossy()}
+    {
+    }
+};
+
+TEST_F(LossyRequestPipelineTest,
+       asyncRequest_WhenRequestsGetLost_WillRetransmitThem)
+{
+    RequestPolicy requestPolicy;
+    requestPolicy.timeout        = 20ms;
+    requestPolicy.maxRetransmits = 20;
+    RequestPipeline requestPipeline{mAsioSerialPortManager, requestPolicy};
+
+    for (auto request = 0; request < 50; ++request)
+    {
+        this->request(requestPipeline, "CAM" + std::to_string(request));
+    }
+
+    ASSERT_TRUE(waitForResponses(50));
+    for (const auto& response : mResponses)
+    {
+        EXPECT_FALSE(response.error);
+    }
+    EXPECT_GT(mSimulatedSerialDevice.droppedBytes(), 0U);
+}
@@ -0,0 +1,103 @@
+#ifndef BREAKTHEDEPENDENCY_SERIALMESSAGE_H
+#define BREAKTHEDEPENDENCY_SERIALMESSAGE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+class SerialMessagePool;
+
+/// Reference counted backing storage of a SerialMessage. The payload bytes
+/// follow the header in the same allocation.
+struct SerialMessageBuffer
+{
+    std::atomic<std::uint32_t> references{1};
+    SerialMessagePool* pool{nullptr};
+    SerialMessageBuffer* nextFree{nullptr};
+
+    char* payload()
+    {
+        return reinterpret_cast<char*>(this + 1);
+    }
+};
+
+/// A payload that can be queued and passed between threads without copying
+/// its bytes. Copies of a message share the same backing buffer, which is
+/// released once the last copy goes away. Literals are referenced in place
+/// and never allocate.
+class SerialMessage
+{
+public:
+    /// Only accepts string literals (or other constant expressions with static
+    /// storage duration) so that the referenced bytes can never dangle
+    template<std::size_t N>
+    consteval SerialMessage(const char (&literal)[N])
+        : mPayload{literal, N - 1}
+    {
+    }
+
+    /// References bytes that the caller guarantees to outlive every copy of
+    /// the message, e.g. frames precomputed at start-up
+    static SerialMessage fromStaticStorage(std::string_view payload);
+    /// Copies the payload into a heap allocated buffer
+    static SerialMessage copyOf(std::string_view payload);
+
+    SerialMessage(const SerialMessage& other) noexcept;
+    // Inline since literals are moved along every layer between a caller and
+    // the serial port and moving or destroying one should cost next to nothing
+    SerialMessage(SerialMessage&& other) noexcept
+        : mPayload{other.mPayload}
+        , mBuffer{other.mBuffer}
+    {
+        other.mBuffer = nullptr;
+    }
+    SerialMessage& operator=(const SerialMessage& other) noexcept;
+    SerialMessage& operator=(SerialMessage&& other) noexcept;
+    ~SerialMessage()
+    {
+        if (mBuffer != nullptr)
+        {
+            release();
+        }
+    }
+
+    std::string_view view() const
+    {
+        return mPayload;
+    }
+
+    const char* data() const
+    {
+        return mPayload.data();
+    }
+
+    std::size_t size() const
+    {
+        return mPayload.size();
+    }
+
+    friend bool operator==(const SerialMessage& lhs, std::string_view rhs)
+    {
+        return lhs.mPayload == rhs;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os,
+                                    const SerialMessage& message)
+    {
+        return os << message.mPayload;
+    }
+
+private:
+    friend class SerialMessagePool;
+
+    SerialMessage(std::string_view payload, SerialMessageBuffer* buffer);
+
+    void release() noexcept;
+
+    std::string_view mPayload;
+    SerialMessageBuffer* mBuffer{nullptr};
+};
+
+#endif // BREAKTHEDEPENDENCY_SERIALMESSAGE_H
@@ -0,0 +1,40 @@
+#ifndef BREAKTHEDEPENDENCY_SERIALMESSAGEPOOL_H
+#define BREAKTHEDEPENDENCY_SERIALMESSAGEPOOL_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string_view>
+
+#include "SerialMessage.h"
+
+/// Fixed set of equally sized buffers carved out of a single allocation.
+/// Messages created by the pool return their buffer to it when the last copy
+/// is destroyed, so the pool must outlive every message it creates.
+class SerialMessagePool
+{
+public:
+    SerialMessagePool(std::size_t slotCount, std::size_t slotCapacity);
+
+    SerialMessagePool(const SerialMessagePool&) = delete;
+    SerialMessagePool& operator=(const SerialMessagePool&) = delete;
+
+    /// Copies the payload into a free slot. Falls back to a heap allocated
+    /// buffer if the payload does not fit in a slot or the pool is exhausted.
+    SerialMessage copy(std::string_view payload);
+
+    std::size_t availableSlots() const;
+
+private:
+    friend class SerialMessage;
+
+    void recycle(SerialMessageBuffer* buffer);
+
+    std::size_t mSlotCapacity;
+    std::unique_ptr<std::byte[]> mArena;
+    mutable std::mutex mFreeListMutex;
+    SerialMessageBuffer* mFreeList{nullptr};
+    std::size_t mAvailableSlots{0};
+};
+
+#endif // BREAKTHEDEPENDENCY_SERIALMESSAGEPOOL_H
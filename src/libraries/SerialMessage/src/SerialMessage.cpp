@@ -0,0 +1,80 @@
+#include <cstring>
+#include <new>
+#include <utility>
+
+#include "SerialMessage.h"
+#include "SerialMessagePool.h"
+
+SerialMessage::SerialMessage(std::string_view payload,
+                             SerialMessageBuffer* buffer)
+    : mPayload{payload}
+    , mBuffer{buffer}
+{
+}
+
+SerialMessage SerialMessage::fromStaticStorage(std::string_view payload)
+{
+    return SerialMessage{payload, nullptr};
+}
+
+SerialMessage SerialMessage::copyOf(std::string_view payload)
+{
+    auto buffer = new (::operator new(sizeof(SerialMessageBuffer)
+                                      + payload.size())) SerialMessageBuffer{};
+    std::memcpy(buffer->payload(), payload.data(), payload.size());
+
+    return SerialMessage{{buffer->payload(), payload.size()}, buffer};
+}
+
+SerialMessage::SerialMessage(const SerialMessage& other) noexcept
+    : mPayload{other.mPayload}
+    , mBuffer{other.mBuffer}
+{
+    if (mBuffer != nullptr)
+    {
+        mBuffer->references.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+SerialMessage& SerialMessage::operator=(const SerialMessage& other) noexcept
+{
+    if (this != &other)
+    {
+        SerialMessage copy{other};
+        *this = std::move(copy);
+    }
+
+    return *this;
+}
+
+SerialMessage& SerialMessage::operator=(SerialMessage&& other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        mPayload = other.mPayload;
+        mBuffer  = std::exchange(other.mBuffer, nullptr);
+    }
+
+    return *this;
+}
+
+void SerialMessage::release() noexcept
+{
+    if (mBuffer == nullptr
+        || mBuffer->references.fetch_sub(1, std::memory_order_acq_rel) != 1)
+    {
+        return;
+    }
+
+    if (mBuffer->pool != nullptr)
+    {
+        mBuffer->pool->recycle(mBuffer);
+    }
+    else
+    {
+        mBuffer->~SerialMessageBuffer();
+        ::operator delete(mBuffer);
+    }
+    mBuffer = nullptr;
+}
@@ -0,0 +1,72 @@
+#include <cstring>
+#include <new>
+
+#include "SerialMessagePool.h"
+
+namespace
+{
+std::size_t slotStride(std::size_t slotCapacity)
+{
+    const auto unaligned = sizeof(SerialMessageBuffer) + slotCapacity;
+    const auto alignment = alignof(SerialMessageBuffer);
+
+    return (unaligned + alignment - 1) / alignment * alignment;
+}
+} // namespace
+
+SerialMessagePool::SerialMessagePool(std::size_t slotCount,
+                                     std::size_t slotCapacity)
+    : mSlotCapacity{slotCapacity}
+    , mArena{std::make_unique<std::byte[]>(slotCount * slotStride(slotCapacity))}
+    , mAvailableSlots{slotCount}
+{
+    const auto stride = slotStride(slotCapacity);
+    for (auto slot = slotCount; slot > 0; --slot)
+    {
+        auto buffer = new (mArena.get() + (slot - 1) * stride)
+            SerialMessageBuffer{};
+        buffer->pool     = this;
+        buffer->nextFree = mFreeList;
+        mFreeList        = buffer;
+    }
+}
+
+SerialMessage SerialMessagePool::copy(std::string_view payload)
+{
+    SerialMessageBuffer* buffer = nullptr;
+    if (payload.size() <= mSlotCapacity)
+    {
+        std::lock_guard lock{mFreeListMutex};
+        if (mFreeList != nullptr)
+        {
+            buffer    = mFreeList;
+            mFreeList = buffer->nextFree;
+            --mAvailableSlots;
+        }
+    }
+
+    if (buffer == nullptr)
+    {
+        return SerialMessage::copyOf(payload);
+    }
+
+    buffer->references.store(1, std::memory_order_relaxed);
+    std::memcpy(buffer->payload(), payload.data(), payload.size());
+
+    return SerialMessage{{buffer->payload(), payload.size()}, buffer};
+}
+
+std::size_t SerialMessagePool::availableSlots() const
+{
+    std::lock_guard lock{mFreeListMutex};
+
+    return mAvailableSlots;
+}
+
+void SerialMessagePool::recycle(SerialMessageBuffer* buffer)
+{
+    std::lock_guard lock{mFreeListMutex};
+    buffer->nextFree = mFreeList;
+    mFreeList        = buffer;
+    ++mAvailableSlots;
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include "SerialMessage.h"
+#include "SerialMessagePool.h"
+
+using namespace std::literals;
+
+namespace
+{
+constexpr auto kTurnOnCommand = "ON";
+} // namespace
+
+TEST(SerialMessageTest, constructor_WhenLiteral_WillReferenceLiteral)
+{
+    const SerialMessage message{"ON"};
+
+    EXPECT_EQ(message, "ON"sv);
+    EXPECT_EQ(message.size(), 2u);
+}
+
+TEST(SerialMessageTest, fromStaticStorage_WhenCalled_WillNotCopyPayload)
+{
+    const auto message = SerialMessage::fromStaticStorage(kTurnOnCommand);
+
+    EXPECT_EQ(message.data(), kTurnOnCommand);
+}
+
+TEST(SerialMessageTest, copyConstructor_WhenCopied_WillShareBuffer)
+{
+    const auto message = SerialMessage::copyOf("OFF"sv);
+    const auto copy    = message;
+
+    EXPECT_EQ(copy.data(), message.data());
+    EXPECT_EQ(copy, "OFF"sv);
+}
+
+struct SerialMessagePoolTest : public ::testing::Test
+{
+    SerialMessagePool mSerialMessagePool{2, 8};
+};
+
+TEST_F(SerialMessagePoolTest, copy_WhenPayloadFits_WillTakeSlot)
+{
+    const auto message = mSerialMessagePool.copy("ON"sv);
+
+    EXPECT_EQ(message, "ON"sv);
+    EXPECT_EQ(mSerialMessagePool.availableSlots(), 1u);
+}
+
+TEST_F(SerialMessagePoolTest, copy_WhenLastCopyReleased_WillReturnSlot)
+{
+    {
+        const auto message = mSerialMessagePool.copy("ON"sv);
+        const auto copy    = message;
+    }
+
+    EXPECT_EQ(mSerialMessagePool.availableSlots(), 2u);
+}
+
+TEST_F(SerialMessagePoolTest, copy_WhenPayloadTooLarge_WillNotTakeSlot)
+{
+    const auto message = mSerialMessagePool.copy("TOO LARGE FOR A SLOT"sv);
+
+    EXPECT_EQ(message, "TOO LARGE FOR A SLOT"sv);
+    EXPECT_EQ(mSerialMessagePool.availableSlots(), 2u);
+}
+
+TEST_F(SerialMessagePoolTest, copy_WhenPoolExhausted_WillStillCopyPayload)
+{
+    const auto first  = mSerialMessagePool.copy("1"sv);
+    const auto second = mSerialMessagePool.copy("2"sv);
+    const auto third  = mSerialMessagePool.copy("3"sv);
+
+    EXPECT_EQ(third, "3"sv);
+    EXPECT_EQ(mSerialMessagePool.availableSlots(), 0u);
+}
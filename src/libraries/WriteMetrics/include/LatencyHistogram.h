@@ -0,0 +1,129 @@
+#ifndef BREAKTHEDEPENDENCY_LATENCYHISTOGRAM_H
+#define BREAKTHEDEPENDENCY_LATENCYHISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+/// Buckets latencies the way HDR histograms do: every power of two of
+/// nanoseconds is split into kSubBuckets equally wide buckets, so a recorded
+/// value is known to within 1/kSubBuckets of itself whatever its magnitude.
+/// Latencies above about 18 minutes land in the last bucket.
+class LatencyHistogram
+{
+public:
+    static constexpr std::size_t kSubBucketBits = 3;
+    static constexpr std::size_t kSubBuckets = std::size_t{1} << kSubBucketBits;
+    static constexpr std::size_t kMaxShift = 40 - kSubBucketBits;
+    static constexpr std::size_t kBuckets = (kMaxShift + 2) * kSubBuckets;
+
+    struct Snapshot
+    {
+        /// The highest latency that falls into the same bucket as the given
+        /// percentile of the recorded ones
+        std::chrono::nanoseconds percentile(double percent) const
+        {
+            if (count == 0)
+            {
+                return {};
+            }
+
+            const auto rank = std::max<std::uint64_t>(
+                1,
+                static_cast<std::uint64_t>(std::ceil(
+                    std::clamp(percent, 0.0, 100.0) / 100.0
+                    * static_cast<double>(count))));
+            std::uint64_t seen = 0;
+            for (std::size_t bucket = 0; bucket < kBuckets; ++bucket)
+            {
+                seen += counts[bucket];
+                if (seen >= rank)
+                {
+                    return std::min(
+                        std::chrono::nanoseconds{
+                            static_cast<std::int64_t>(upperBound(bucket) - 1)},
+                        max);
+                }
+            }
+
+            return max;
+        }
+
+        std::array<std::uint64_t, kBuckets> counts{};
+        std::uint64_t count{0};
+        std::chrono::nanoseconds max{};
+    };
+
+    /// Lock-free and wait-free apart from keeping track of the maximum
+    void record(std::chrono::nanoseconds latency)
+    {
+        const auto nanoseconds
+            = static_cast<std::uint64_t>(std::max<std::int64_t>(latency.count(), 0));
+        mCounts[bucketOf(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+
+        auto max = mMax.load(std::memory_order_relaxed);
+        while (nanoseconds > max
+               && !mMax.compare_exchange_weak(
+                   max, nanoseconds, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    /// The buckets are read one by one while others may still record, so
+    /// a snapshot taken under load is not a single point in time
+    Snapshot snapshot() const
+    {
+        Snapshot snapshot;
+        for (std::size_t bucket = 0; bucket < kBuckets; ++bucket)
+        {
+            snapshot.counts[bucket]
+                = mCounts[bucket].load(std::memory_order_relaxed);
+            snapshot.count += snapshot.counts[bucket];
+        }
+        snapshot.max = std::chrono::nanoseconds{
+            static_cast<std::int64_t>(mMax.load(std::memory_order_relaxed))};
+
+        return snapshot;
+    }
+
+    static constexpr std::size_t bucketOf(std::uint64_t nanoseconds)
+    {
+        if (nanoseconds < kSubBuckets)
+        {
+            return static_cast<std::size_t>(nanoseconds);
+        }
+
+        const auto shift = std::min<std::size_t>(
+            static_cast<std::size_t>(std::bit_width(nanoseconds)) - 1
+                - kSubBucketBits,
+            kMaxShift);
+        const auto subBucket = std::min<std::uint64_t>(
+            nanoseconds >> shift, 2 * kSubBuckets - 1);
+
+        return (shift + 1) * kSubBuckets
+               + static_cast<std::size_t>(subBucket - kSubBuckets);
+    }
+
+    static constexpr std::uint64_t upperBound(std::size_t bucket)
+    {
+        if (bucket < kSubBuckets)
+        {
+            return bucket + 1;
+        }
+
+        const auto shift = bucket / kSubBuckets - 1;
+
+        return (kSubBuckets + bucket % kSubBuckets + 1) << shift;
+    }
+
+private:
+    std::array<std::atomic<std::uint64_t>, kBuckets> mCounts{};
+    std::atomic<std::uint64_t> mMax{0};
+};
+
+#endif // BREAKTHEDEPENDENCY_LATENCYHISTOGRAM_H
@@ -0,0 +1,118 @@
+#ifndef BREAKTHEDEPENDENCY_WRITEMETRICS_H
+#define BREAKTHEDEPENDENCY_WRITEMETRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+
+#include "LatencyHistogram.h"
+
+#ifndef BREAKTHEDEPENDENCY_INSTRUMENTATION
+#define BREAKTHEDEPENDENCY_INSTRUMENTATION 1
+#endif
+
+struct WriteMetricsSnapshot
+{
+    std::uint64_t writes{0};
+    std::uint64_t bytesWritten{0};
+    std::uint64_t failedWrites{0};
+    /// Superseded or evicted before they were written
+    std::uint64_t abortedWrites{0};
+    /// Turned away by a full queue
+    std::uint64_t rejectedWrites{0};
+    /// From queueing a successful write until it has left the serial port
+    LatencyHistogram::Snapshot latency;
+};
+
+/// Counts the outcome of writes and how long the successful ones took. With
+/// BREAKTHEDEPENDENCY_INSTRUMENTATION set to 0 it is empty, its timestamps
+/// are empty and every call compiles to nothing.
+class WriteMetrics
+{
+public:
+    static constexpr bool kEnabled = BREAKTHEDEPENDENCY_INSTRUMENTATION != 0;
+
+#if BREAKTHEDEPENDENCY_INSTRUMENTATION
+    using Timestamp = std::chrono::steady_clock::time_point;
+
+    static Timestamp now()
+    {
+        return std::chrono::steady_clock::now();
+    }
+
+    void recordCompletion(Timestamp queuedAt,
+                          std::error_code error,
+                          std::size_t bytesWritten)
+    {
+        if (error == std::errc::operation_canceled)
+        {
+            mAbortedWrites.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (error)
+        {
+            mFailedWrites.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        mWrites.fetch_add(1, std::memory_order_relaxed);
+        mBytesWritten.fetch_add(bytesWritten, std::memory_order_relaxed);
+        mLatency.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            now() - queuedAt));
+    }
+
+    void recordRejection()
+    {
+        mRejectedWrites.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// Each counter is read on its own, see LatencyHistogram::snapshot()
+    WriteMetricsSnapshot snapshot() const
+    {
+        WriteMetricsSnapshot snapshot;
+        snapshot.writes = mWrites.load(std::memory_order_relaxed);
+        snapshot.bytesWritten = mBytesWritten.load(std::memory_order_relaxed);
+        snapshot.failedWrites = mFailedWrites.load(std::memory_order_relaxed);
+        snapshot.abortedWrites = mAbortedWrites.load(std::memory_order_relaxed);
+        snapshot.rejectedWrites
+            = mRejectedWrites.load(std::memory_order_relaxed);
+        snapshot.latency = mLatency.snapshot();
+
+        return snapshot;
+    }
+
+private:
+    std::atomic<std::uint64_t> mWrites{0};
+    std::atomic<std::uint64_t> mBytesWritten{0};
+    std::atomic<std::uint64_t> mFailedWrites{0};
+    std::atomic<std::uint64_t> mAbortedWrites{0};
+    std::atomic<std::uint64_t> mRejectedWrites{0};
+    LatencyHistogram mLatency;
+#else
+    struct Timestamp
+    {
+    };
+
+    static Timestamp now()
+    {
+        return {};
+    }
+
+    void recordCompletion(Timestamp, std::error_code, std::size_t)
+    {
+    }
+
+    void recordRejection()
+    {
+    }
+
+    WriteMetricsSnapshot snapshot() const
+    {
+        return {};
+    }
+#endif
+};
+
+#endif // BREAKTHEDEPENDENCY_WRITEMETRICS_H
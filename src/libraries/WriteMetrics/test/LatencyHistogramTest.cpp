@@ -0,0 +1,74 @@
+#include <chrono>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+#include "LatencyHistogram.h"
+
+using namespace std::literals;
+
+TEST(LatencyHistogramTest, bucketOf_WhenValuesIncrease_WillNeverSkipABucket)
+{
+    auto previousBucket = LatencyHistogram::bucketOf(0);
+    for (std::uint64_t nanoseconds = 1; nanoseconds < 100'000; ++nanoseconds)
+    {
+        const auto bucket = LatencyHistogram::bucketOf(nanoseconds);
+        EXPECT_TRUE(bucket == previousBucket || bucket == previousBucket + 1)
+            << nanoseconds;
+        EXPECT_LT(nanoseconds, LatencyHistogram::upperBound(bucket));
+        previousBucket = bucket;
+    }
+}
+
+TEST(LatencyHistogramTest, bucketOf_WhenAnyValue_WillBeWithinTheBucketPrecision)
+{
+    for (std::uint64_t nanoseconds = 8; nanoseconds < (1ULL << 36);
+         nanoseconds = nanoseconds * 3 + 1)
+    {
+        const auto upperBound = LatencyHistogram::upperBound(
+            LatencyHistogram::bucketOf(nanoseconds));
+        EXPECT_GT(upperBound, nanoseconds);
+        EXPECT_LE(upperBound - nanoseconds,
+                  nanoseconds / LatencyHistogram::kSubBuckets + 1);
+    }
+}
+
+TEST(LatencyHistogramTest, bucketOf_WhenValueHuge_WillUseLastBucket)
+{
+    EXPECT_EQ(LatencyHistogram::bucketOf(UINT64_MAX),
+              LatencyHistogram::kBuckets - 1);
+}
+
+TEST(LatencyHistogramTest, percentile_WhenNothingRecorded_WillBeZero)
+{
+    LatencyHistogram latencyHistogram;
+
+    EXPECT_EQ(latencyHistogram.snapshot().percentile(99.0), 0ns);
+}
+
+TEST(LatencyHistogramTest, percentile_WhenRecorded_WillFindTheRankedLatency)
+{
+    LatencyHistogram latencyHistogram;
+    for (auto i = 1; i <= 100; ++i)
+    {
+        latencyHistogram.record(std::chrono::microseconds{i});
+    }
+
+    const auto snapshot = latencyHistogram.snapshot();
+
+    EXPECT_EQ(snapshot.count, 100U);
+    EXPECT_EQ(snapshot.max, 100us);
+    EXPECT_GE(snapshot.percentile(50.0), 50us);
+    EXPECT_LE(snapshot.percentile(50.0), 50us + 50us / 8);
+    EXPECT_GE(snapshot.percentile(99.0), 99us);
+    EXPECT_EQ(snapshot.percentile(100.0), 100us);
+}
+
+TEST(LatencyHistogramTest, record_WhenNegative_WillCountAsZero)
+{
+    LatencyHistogram latencyHistogram;
+
+    latencyHistogram.record(-5ns);
+
+    EXPECT_EQ(latencyHistogram.snapshot().counts[0], 1U);
+}
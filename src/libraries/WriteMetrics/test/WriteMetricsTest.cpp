@@ -0,0 +1,59 @@
+#include <system_error>
+
+#include "gtest/gtest.h"
+
+#include "WriteMetrics.h"
+
+struct WriteMetricsTest : public ::testing::Test
+{
+    void SetUp() override
+    {
+        if (!WriteMetrics::kEnabled)
+        {
+            GTEST_SKIP() << "Built without instrumentation";
+        }
+    }
+
+    WriteMetrics mWriteMetrics;
+};
+
+TEST_F(WriteMetricsTest, recordCompletion_WhenSuccessful_WillCountWriteAndBytes)
+{
+    mWriteMetrics.recordCompletion(WriteMetrics::now(), {}, 3);
+    mWriteMetrics.recordCompletion(WriteMetrics::now(), {}, 2);
+
+    const auto snapshot = mWriteMetrics.snapshot();
+    EXPECT_EQ(snapshot.writes, 2U);
+    EXPECT_EQ(snapshot.bytesWritten, 5U);
+    EXPECT_EQ(snapshot.latency.count, 2U);
+}
+
+TEST_F(WriteMetricsTest, recordCompletion_WhenAborted_WillOnlyCountAbort)
+{
+    mWriteMetrics.recordCompletion(
+        WriteMetrics::now(),
+        std::make_error_code(std::errc::operation_canceled),
+        0);
+
+    const auto snapshot = mWriteMetrics.snapshot();
+    EXPECT_EQ(snapshot.abortedWrites, 1U);
+    EXPECT_EQ(snapshot.writes, 0U);
+    EXPECT_EQ(snapshot.latency.count, 0U);
+}
+
+TEST_F(WriteMetricsTest, recordCompletion_WhenFailed_WillOnlyCountFailure)
+{
+    mWriteMetrics.recordCompletion(
+        WriteMetrics::now(), std::make_error_code(std::errc::io_error), 0);
+
+    const auto snapshot = mWriteMetrics.snapshot();
+    EXPECT_EQ(snapshot.failedWrites, 1U);
+    EXPECT_EQ(snapshot.writes, 0U);
+}
+
+TEST_F(WriteMetricsTest, recordRejection_WhenCalled_WillCountRejection)
+{
+    mWriteMetrics.recordRejection();
+
+    EXPECT_EQ(mWriteMetrics.snapshot().rejectedWrites, 1U);
+}
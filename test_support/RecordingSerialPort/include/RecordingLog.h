@@ -0,0 +1,95 @@
+#ifndef BREAKTHEDEPENDENCY_RECORDINGLOG_H
+#define BREAKTHEDEPENDENCY_RECORDINGLOG_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "SerialMessage.h"
+
+/// Records serial messages from any number of threads at once, for fakes that
+/// stand in for a serial port under load. Every thread appends to a log of its
+/// own, so recording neither takes a lock nor contends with the other threads:
+/// after the first message of a thread it is a store of the message and a
+/// release store of the thread's count. The messages of a thread keep the
+/// order it recorded them in, there is no order across threads. A thread that
+/// starts once another one has ended may carry on with its log, since the two
+/// can get the same id.
+class RecordingLog
+{
+public:
+    struct ThreadRecording
+    {
+        std::thread::id thread;
+        std::vector<SerialMessage> messages;
+    };
+
+    RecordingLog();
+    ~RecordingLog();
+
+    RecordingLog(const RecordingLog&)            = delete;
+    RecordingLog& operator=(const RecordingLog&) = delete;
+
+    void record(SerialMessage message);
+
+    /// The readers may run while other threads record and see every message
+    /// recorded before they were called, possibly more
+    std::size_t size() const;
+    /// How many of the messages recorded so far equal `payload`
+    std::size_t count(std::string_view payload) const;
+    std::vector<ThreadRecording> byThread() const;
+
+    /// Forgets what was recorded. No thread may record meanwhile.
+    void clear();
+
+private:
+    static constexpr std::size_t kChunkSize = 1024;
+
+    /// SerialMessage has no empty state of its own
+    struct Slot
+    {
+        SerialMessage message{""};
+    };
+
+    struct Chunk
+    {
+        std::array<Slot, kChunkSize> slots;
+        Chunk* next{nullptr};
+    };
+
+    struct ThreadLog
+    {
+        explicit ThreadLog(std::thread::id owner);
+        ~ThreadLog();
+
+        /// Only called by the owner
+        void append(SerialMessage message);
+        template<typename Visit>
+        void forEach(Visit visit) const;
+
+        const std::thread::id thread;
+        // Set once the thread log is published and never changed afterwards
+        ThreadLog* next{nullptr};
+        Chunk* const head;
+        Chunk* tail;
+        // Published with release after the message and any chunk it needed
+        std::atomic<std::size_t> size{0};
+    };
+
+    ThreadLog& threadLog();
+    ThreadLog* findThreadLog(std::thread::id thread) const;
+    template<typename Visit>
+    void forEachThreadLog(Visit visit) const;
+
+    /// Never reused, so that a thread's cache of logs cannot mistake a new log
+    /// for one that was destroyed at the same address
+    const std::uint64_t mId;
+    // Only ever pushed to
+    std::atomic<ThreadLog*> mThreadLogs{nullptr};
+};
+
+#endif // BREAKTHEDEPENDENCY_RECORDINGLOG_H
@@ -0,0 +1,28 @@
+#ifndef BREAKTHEDEPENDENCY_RECORDINGSERIALPORTS_H
+#define BREAKTHEDEPENDENCY_RECORDINGSERIALPORTS_H
+
+#include <cstddef>
+#include <string_view>
+
+#include "RecordingLog.h"
+
+/// A RecordingLog per serial device, for fakes that only learn which port
+/// they stand for from the device they are constructed with, e.g. the
+/// link-time AsioSerialPortManager. Every fake of the same device records to
+/// the same log, like the managers of a shared port would write to it.
+class RecordingSerialPorts
+{
+public:
+    static constexpr std::size_t kMaxSerialPorts = 64;
+
+    /// Creates the log the first time a device is asked for and keeps it for
+    /// the rest of the program. Looking up a device that already has one
+    /// neither locks nor allocates. Throws std::length_error once
+    /// kMaxSerialPorts devices have a log.
+    static RecordingLog& of(std::string_view serialDevice);
+
+    /// Clears the logs of every device. No thread may record meanwhile.
+    static void clear();
+};
+
+#endif // BREAKTHEDEPENDENCY_RECORDINGSERIALPORTS_H
@@ -0,0 +1,195 @@
+#include <utility>
+
+#include "RecordingLog.h"
+
+namespace
+{
+std::atomic<std::uint64_t> gNextLogId{1};
+
+/// Remembers the thread logs of the last few logs the thread recorded to, so
+/// that alternating between the logs of several ports stays cheap. Zero is not
+/// a log id, so empty entries never match.
+struct CachedThreadLog
+{
+    std::uint64_t logId;
+    void* threadLog;
+};
+constexpr std::size_t kThreadLogCacheSize = 8;
+thread_local std::array<CachedThreadLog, kThreadLogCacheSize> tThreadLogCache{};
+} // namespace
+
+RecordingLog::ThreadLog::ThreadLog(std::thread::id owner)
+    : thread{owner}
+    , head{new Chunk}
+    , tail{head}
+{
+}
+
+RecordingLog::ThreadLog::~ThreadLog()
+{
+    for (auto* chunk = head; chunk != nullptr;)
+    {
+        delete std::exchange(chunk, chunk->next);
+    }
+}
+
+void RecordingLog::ThreadLog::append(SerialMessage message)
+{
+    const auto index = size.load(std::memory_order_relaxed);
+    const auto slot  = index % kChunkSize;
+    if (slot == 0 && index != 0)
+    {
+        // Chunks left behind by clear() are filled again before new ones
+        if (tail->next == nullptr)
+        {
+            tail->next = new Chunk;
+        }
+        tail = tail->next;
+    }
+
+    tail->slots[slot].message = std::move(message);
+    size.store(index + 1, std::memory_order_release);
+}
+
+template<typename Visit>
+void RecordingLog::ThreadLog::forEach(Visit visit) const
+{
+    const auto recorded = size.load(std::memory_order_acquire);
+    const auto* chunk   = head;
+    for (std::size_t index = 0; index < recorded; ++index)
+    {
+        if (index != 0 && index % kChunkSize == 0)
+        {
+            chunk = chunk->next;
+        }
+        visit(chunk->slots[index % kChunkSize].message);
+    }
+}
+
+RecordingLog::RecordingLog()
+    : mId{gNextLogId.fetch_add(1, std::memory_order_relaxed)}
+{
+}
+
+RecordingLog::~RecordingLog()
+{
+    for (auto* threadLog = mThreadLogs.load(); threadLog != nullptr;)
+    {
+        delete std::exchange(threadLog, threadLog->next);
+    }
+}
+
+void RecordingLog::record(SerialMessage message)
+{
+    threadLog().append(std::move(message));
+}
+
+std::size_t RecordingLog::size() const
+{
+    std::size_t messages = 0;
+    forEachThreadLog([&messages](const ThreadLog& threadLog) {
+        messages += threadLog.size.load(std::memory_order_acquire);
+    });
+
+    return messages;
+}
+
+std::size_t RecordingLog::count(std::string_view payload) const
+{
+    std::size_t matches = 0;
+    forEachThreadLog([payload, &matches](const ThreadLog& threadLog) {
+        threadLog.forEach([payload, &matches](const SerialMessage& message) {
+            if (message == payload)
+            {
+                ++matches;
+            }
+        });
+    });
+
+    return matches;
+}
+
+std::vector<RecordingLog::ThreadRecording> RecordingLog::byThread() const
+{
+    std::vector<ThreadRecording> threadRecordings;
+    forEachThreadLog([&threadRecordings](const ThreadLog& threadLog) {
+        auto& threadRecording = threadRecordings.emplace_back(
+            ThreadRecording{threadLog.thread, {}});
+        threadLog.forEach([&threadRecording](const SerialMessage& message) {
+            threadRecording.messages.push_back(message);
+        });
+    });
+
+    return threadRecordings;
+}
+
+void RecordingLog::clear()
+{
+    for (auto* threadLog = mThreadLogs.load(); threadLog != nullptr;
+         threadLog       = threadLog->next)
+    {
+        // Also releases the buffers of messages that are not literals
+        for (auto* chunk = threadLog->head; chunk != nullptr;
+             chunk       = chunk->next)
+        {
+            chunk->slots = {};
+        }
+        threadLog->tail = threadLog->head;
+        threadLog->size.store(0);
+    }
+}
+
+RecordingLog::ThreadLog& RecordingLog::threadLog()
+{
+    auto& cached = tThreadLogCache[mId % kThreadLogCacheSize];
+    if (cached.logId == mId)
+    {
+        return *static_cast<ThreadLog*>(cached.threadLog);
+    }
+
+    const auto thisThread = std::this_thread::get_id();
+    auto* threadLog       = findThreadLog(thisThread);
+    if (threadLog == nullptr)
+    {
+        // Only the owner ever creates its thread log, so it cannot have been
+        // published by someone else in the meantime
+        threadLog       = new ThreadLog{thisThread};
+        threadLog->next = mThreadLogs.load(std::memory_order_relaxed);
+        while (!mThreadLogs.compare_exchange_weak(threadLog->next,
+                                                  threadLog,
+                                                  std::memory_order_release,
+                                                  std::memory_order_relaxed))
+        {
+        }
+    }
+
+    cached = {mId, threadLog};
+    return *threadLog;
+}
+
+RecordingLog::ThreadLog*
+RecordingLog::findThreadLog(std::thread::id thread) const
+{
+    for (auto* threadLog = mThreadLogs.load(std::memory_order_acquire);
+         threadLog != nullptr;
+         threadLog = threadLog->next)
+    {
+        if (threadLog->thread == thread)
+        {
+            return threadLog;
+        }
+    }
+
+    return nullptr;
+}
+
+template<typename Visit>
+void RecordingLog::forEachThreadLog(Visit visit) const
+{
+    for (auto* threadLog = mThreadLogs.load(std::memory_order_acquire);
+         threadLog != nullptr;
+         threadLog = threadLog->next)
+    {
+        visit(*threadLog);
+    }
+}
@@ -0,0 +1,90 @@
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+#include "RecordingSerialPorts.h"
+
+namespace
+{
+struct RecordingSerialPort
+{
+    explicit RecordingSerialPort(std::string_view device)
+        : serialDevice{device}
+    {
+    }
+
+    const std::string serialDevice;
+    RecordingLog recordingLog;
+};
+
+/// Ports are only ever added, each one is published by the release store of
+/// the count after it has been constructed
+struct Registry
+{
+    RecordingSerialPort* find(std::string_view serialDevice,
+                              std::size_t ports) const
+    {
+        for (std::size_t i = 0; i < ports; ++i)
+        {
+            if (serialPorts[i]->serialDevice == serialDevice)
+            {
+                return serialPorts[i];
+            }
+        }
+
+        return nullptr;
+    }
+
+    std::array<RecordingSerialPort*, RecordingSerialPorts::kMaxSerialPorts>
+        serialPorts{};
+    std::atomic<std::size_t> size{0};
+    std::mutex addMutex;
+};
+
+Registry& registry()
+{
+    // Never destroyed, so that fakes that are destroyed at exit can still
+    // look up their log
+    static auto* instance = new Registry;
+
+    return *instance;
+}
+} // namespace
+
+RecordingLog& RecordingSerialPorts::of(std::string_view serialDevice)
+{
+    auto& ports = registry();
+    if (auto* serialPort
+        = ports.find(serialDevice, ports.size.load(std::memory_order_acquire)))
+    {
+        return serialPort->recordingLog;
+    }
+
+    std::lock_guard lock{ports.addMutex};
+    const auto size = ports.size.load(std::memory_order_relaxed);
+    if (auto* serialPort = ports.find(serialDevice, size))
+    {
+        return serialPort->recordingLog;
+    }
+    if (size == kMaxSerialPorts)
+    {
+        throw std::length_error{"Too many recording serial ports"};
+    }
+
+    ports.serialPorts[size] = new RecordingSerialPort{serialDevice};
+    ports.size.store(size + 1, std::memory_order_release);
+
+    return ports.serialPorts[size]->recordingLog;
+}
+
+void RecordingSerialPorts::clear()
+{
+    auto& ports = registry();
+    std::lock_guard lock{ports.addMutex};
+    for (std::size_t i = 0; i < ports.size.load(); ++i)
+    {
+        ports.serialPorts[i]->recordingLog.clear();
+    }
+}
@@ -0,0 +1,99 @@
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "RecordingLog.h"
+#include "RecordingSerialPorts.h"
+
+using namespace std::literals;
+
+namespace
+{
+constexpr std::size_t kThreads = 8;
+// Spans a few chunks of every thread's log
+constexpr std::size_t kMessagesPerThread = 5000;
+
+void recordAlternately(RecordingLog& recordingLog, std::size_t messages)
+{
+    for (std::size_t i = 0; i < messages; ++i)
+    {
+        recordingLog.record(i % 2 == 0 ? SerialMessage{"ON"}
+                                       : SerialMessage{"OFF"});
+    }
+}
+} // namespace
+
+TEST(RecordingLogTest, record_WhenManyThreadsRecord_WillKeepOrderOfEachThread)
+{
+    RecordingLog recordingLog;
+
+    std::vector<std::thread> producers;
+    for (std::size_t i = 0; i < kThreads; ++i)
+    {
+        producers.emplace_back([&recordingLog] {
+            recordAlternately(recordingLog, kMessagesPerThread);
+        });
+    }
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+
+    EXPECT_EQ(recordingLog.size(), kThreads * kMessagesPerThread);
+    EXPECT_EQ(recordingLog.count("ON"), kThreads * kMessagesPerThread / 2);
+    const auto threadRecordings = recordingLog.byThread();
+    ASSERT_EQ(threadRecordings.size(), kThreads);
+    for (const auto& threadRecording : threadRecordings)
+    {
+        ASSERT_EQ(threadRecording.messages.size(), kMessagesPerThread);
+        for (std::size_t i = 0; i < kMessagesPerThread; ++i)
+        {
+            ASSERT_EQ(threadRecording.messages[i],
+                      i % 2 == 0 ? "ON"sv : "OFF"sv);
+        }
+    }
+}
+
+TEST(RecordingLogTest, size_WhenReadWhileRecording_WillNeverShrink)
+{
+    RecordingLog recordingLog;
+    std::atomic<bool> recording{true};
+
+    std::thread producer{[&] {
+        recordAlternately(recordingLog, kMessagesPerThread);
+        recording.store(false);
+    }};
+    std::size_t lastSize = 0;
+    while (recording.load())
+    {
+        const auto size = recordingLog.size();
+        EXPECT_GE(size, lastSize);
+        lastSize = size;
+    }
+    producer.join();
+
+    EXPECT_EQ(recordingLog.size(), kMessagesPerThread);
+}
+
+TEST(RecordingLogTest, clear_WhenCalled_WillStartOver)
+{
+    RecordingLog recordingLog;
+    recordAlternately(recordingLog, kMessagesPerThread);
+
+    recordingLog.clear();
+    recordingLog.record(SerialMessage::copyOf("AGAIN"));
+
+    EXPECT_EQ(recordingLog.size(), 1U);
+    EXPECT_EQ(recordingLog.count("AGAIN"), 1U);
+}
+
+TEST(RecordingSerialPortsTest, of_WhenSameDevice_WillReturnSameLog)
+{
+    auto& recordingLog = RecordingSerialPorts::of("/dev/ttyRecording0");
+
+    EXPECT_EQ(&RecordingSerialPorts::of("/dev/ttyRecording0"), &recordingLog);
+    EXPECT_NE(&RecordingSerialPorts::of("/dev/ttyRecording1"), &recordingLog);
+}
@@ -0,0 +1,24 @@
+#ifndef BREAKTHEDEPENDENCY_HEAPGUARD_H
+#define BREAKTHEDEPENDENCY_HEAPGUARD_H
+
+#include <cstddef>
+
+/// The operator new of the resource_tracking library throws std::bad_alloc on
+/// threads where a HeapGuard is alive, instead of counting the allocation, so
+/// that code meant to run without the heap fails the test as soon as it
+/// allocates. Other threads, e.g. those of test support, allocate as usual.
+class HeapGuard
+{
+public:
+    HeapGuard();
+    ~HeapGuard();
+
+    HeapGuard(const HeapGuard&)            = delete;
+    HeapGuard& operator=(const HeapGuard&) = delete;
+
+    /// Allocations refused on this thread since its outermost guard was
+    /// created, also after the guard is gone
+    static std::size_t refusedAllocations();
+};
+
+#endif // BREAKTHEDEPENDENCY_HEAPGUARD_H
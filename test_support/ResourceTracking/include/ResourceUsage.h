@@ -0,0 +1,45 @@
+#ifndef BREAKTHEDEPENDENCY_RESOURCEUSAGE_H
+#define BREAKTHEDEPENDENCY_RESOURCEUSAGE_H
+
+#include <cstddef>
+#include <ostream>
+
+/// What a thread has asked of the heap and the kernel. Linking the
+/// resource_tracking library replaces the global operator new and the libc
+/// wrappers of the I/O syscalls, i.e. read, write, readv, writev, ioctl, poll,
+/// epoll_wait and epoll_ctl, with ones that count each call on the calling
+/// thread. Syscalls libc makes on its own, e.g. within tcsetattr, are not seen.
+struct ResourceUsage
+{
+    std::size_t allocations;
+    std::size_t bytesAllocated;
+    std::size_t syscalls;
+    /// The share of `syscalls` that were write or writev
+    std::size_t writeSyscalls;
+
+    friend bool operator==(const ResourceUsage&, const ResourceUsage&)
+        = default;
+};
+
+/// Totals of the calling thread since it started
+ResourceUsage resourceUsageOfThisThread();
+
+constexpr ResourceUsage operator-(const ResourceUsage& after,
+                                  const ResourceUsage& before)
+{
+    return {after.allocations - before.allocations,
+            after.bytesAllocated - before.bytesAllocated,
+            after.syscalls - before.syscalls,
+            after.writeSyscalls - before.writeSyscalls};
+}
+
+inline std::ostream& operator<<(std::ostream& os,
+                                const ResourceUsage& resourceUsage)
+{
+    return os << resourceUsage.allocations << " allocations of "
+              << resourceUsage.bytesAllocated << " bytes, "
+              << resourceUsage.syscalls << " syscalls of which "
+              << resourceUsage.writeSyscalls << " writes";
+}
+
+#endif // BREAKTHEDEPENDENCY_RESOURCEUSAGE_H
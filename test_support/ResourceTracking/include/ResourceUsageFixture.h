@@ -0,0 +1,26 @@
+#ifndef BREAKTHEDEPENDENCY_RESOURCEUSAGEFIXTURE_H
+#define BREAKTHEDEPENDENCY_RESOURCEUSAGEFIXTURE_H
+
+#include <utility>
+
+#include "gtest/gtest.h"
+
+#include "ResourceUsage.h"
+
+/// For tests that pin down how much of the heap and the kernel a block of code
+/// needs, registered with configure_resource_tracking_test. Only the test's own
+/// thread is measured, so the threads of test support, e.g. a
+/// SimulatedSerialDevice, do not add to the counts.
+struct ResourceUsageFixture : public ::testing::Test
+{
+    template<typename Code>
+    static ResourceUsage measure(Code&& code)
+    {
+        const auto before = resourceUsageOfThisThread();
+        std::forward<Code>(code)();
+
+        return resourceUsageOfThisThread() - before;
+    }
+};
+
+#endif // BREAKTHEDEPENDENCY_RESOURCEUSAGEFIXTURE_H
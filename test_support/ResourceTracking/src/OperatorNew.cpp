@@ -0,0 +1,129 @@
+#include <cstdlib>
+#include <new>
+
+#include "HeapGuard.h"
+#include "ThreadResourceUsage.h"
+
+namespace
+{
+thread_local int tGuards                     = 0;
+thread_local std::size_t tRefusedAllocations = 0;
+
+void countAllocation(std::size_t size)
+{
+    if (tGuards > 0)
+    {
+        ++tRefusedAllocations;
+        throw std::bad_alloc{};
+    }
+
+    auto& resourceUsage = threadResourceUsage();
+    ++resourceUsage.allocations;
+    resourceUsage.bytesAllocated += size;
+}
+
+void* allocate(std::size_t size)
+{
+    countAllocation(size);
+
+    // malloc(0) may return a null pointer, operator new must not
+    if (auto* memory = std::malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    }
+    throw std::bad_alloc{};
+}
+
+void* allocate(std::size_t size, std::align_val_t alignment)
+{
+    countAllocation(size);
+
+    const auto align = static_cast<std::size_t>(alignment);
+    // aligned_alloc wants a multiple of the alignment
+    const auto rounded = (size + align - 1) / align * align;
+    if (auto* memory
+        = std::aligned_alloc(align, rounded == 0 ? align : rounded))
+    {
+        return memory;
+    }
+    throw std::bad_alloc{};
+}
+} // namespace
+
+HeapGuard::HeapGuard()
+{
+    if (tGuards++ == 0)
+    {
+        tRefusedAllocations = 0;
+    }
+}
+
+HeapGuard::~HeapGuard()
+{
+    --tGuards;
+}
+
+std::size_t HeapGuard::refusedAllocations()
+{
+    return tRefusedAllocations;
+}
+
+void* operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocate(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return allocate(size, alignment);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
@@ -0,0 +1,123 @@
+#include <cstdarg>
+
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "ThreadResourceUsage.h"
+
+namespace
+{
+// Trivial, so that taking it neither allocates nor calls into anything that
+// could make a syscall of its own
+thread_local ResourceUsage tResourceUsage{0, 0, 0, 0};
+
+void countSyscall()
+{
+    ++tResourceUsage.syscalls;
+}
+
+void countWriteSyscall()
+{
+    ++tResourceUsage.syscalls;
+    ++tResourceUsage.writeSyscalls;
+}
+
+/// Same size as the kernel's sigset_t, which is all the *pwait and ppoll
+/// syscalls accept
+constexpr auto kKernelSigsetSize = sizeof(unsigned long);
+} // namespace
+
+ResourceUsage& threadResourceUsage()
+{
+    return tResourceUsage;
+}
+
+ResourceUsage resourceUsageOfThisThread()
+{
+    return tResourceUsage;
+}
+
+// Being defined in the executable, these take the place of the libc wrappers
+// for every caller in it, including asio. They make the syscalls themselves
+// through syscall(), which sets errno like the wrappers would.
+extern "C"
+{
+    ssize_t read(int fd, void* buffer, size_t count)
+    {
+        countSyscall();
+        return ::syscall(SYS_read, fd, buffer, count);
+    }
+
+    ssize_t write(int fd, const void* buffer, size_t count)
+    {
+        countWriteSyscall();
+        return ::syscall(SYS_write, fd, buffer, count);
+    }
+
+    ssize_t readv(int fd, const struct iovec* buffers, int count)
+    {
+        countSyscall();
+        return ::syscall(SYS_readv, fd, buffers, count);
+    }
+
+    ssize_t writev(int fd, const struct iovec* buffers, int count)
+    {
+        countWriteSyscall();
+        return ::syscall(SYS_writev, fd, buffers, count);
+    }
+
+    int ioctl(int fd, unsigned long request, ...) noexcept
+    {
+        countSyscall();
+        va_list arguments;
+        va_start(arguments, request);
+        auto* argument = va_arg(arguments, void*);
+        va_end(arguments);
+
+        return static_cast<int>(::syscall(SYS_ioctl, fd, request, argument));
+    }
+
+    int poll(struct pollfd* fds, nfds_t count, int timeoutMilliseconds)
+    {
+        countSyscall();
+        // Not every architecture has a poll syscall, but they all have ppoll
+        timespec timeout{timeoutMilliseconds / 1000,
+                         (timeoutMilliseconds % 1000) * 1'000'000L};
+
+        return static_cast<int>(::syscall(SYS_ppoll,
+                                          fds,
+                                          count,
+                                          timeoutMilliseconds < 0 ? nullptr
+                                                                  : &timeout,
+                                          nullptr,
+                                          kKernelSigsetSize));
+    }
+
+    int epoll_wait(int epollFd,
+                   struct epoll_event* events,
+                   int maxEvents,
+                   int timeoutMilliseconds)
+    {
+        countSyscall();
+        // Same as for poll, epoll_pwait is there everywhere
+        return static_cast<int>(::syscall(SYS_epoll_pwait,
+                                          epollFd,
+                                          events,
+                                          maxEvents,
+                                          timeoutMilliseconds,
+                                          nullptr,
+                                          kKernelSigsetSize));
+    }
+
+    int epoll_ctl(int epollFd, int operation, int fd, struct epoll_event* event)
+        noexcept
+    {
+        countSyscall();
+        return static_cast<int>(
+            ::syscall(SYS_epoll_ctl, epollFd, operation, fd, event));
+    }
+}
@@ -0,0 +1,10 @@
+#ifndef BREAKTHEDEPENDENCY_THREADRESOURCEUSAGE_H
+#define BREAKTHEDEPENDENCY_THREADRESOURCEUSAGE_H
+
+#include "ResourceUsage.h"
+
+/// The running totals of the calling thread, for the replaced operator new and
+/// syscall wrappers to add to
+ResourceUsage& threadResourceUsage();
+
+#endif // BREAKTHEDEPENDENCY_THREADRESOURCEUSAGE_H
@@ -0,0 +1,59 @@
+#include <array>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "ResourceUsageFixture.h"
+
+struct ResourceUsageFixtureTest : public ResourceUsageFixture
+{
+    ResourceUsageFixtureTest()
+    {
+        EXPECT_EQ(::pipe(mPipe.data()), 0);
+    }
+
+    ~ResourceUsageFixtureTest() override
+    {
+        ::close(mPipe[0]);
+        ::close(mPipe[1]);
+    }
+
+    std::array<int, 2> mPipe{-1, -1};
+};
+
+TEST_F(ResourceUsageFixtureTest, measure_WhenCodeAllocates_WillCountBytes)
+{
+    std::vector<char> bytes;
+
+    const auto resourceUsage = measure([&bytes] { bytes.resize(100); });
+
+    EXPECT_EQ(resourceUsage, (ResourceUsage{1, 100, 0, 0}));
+}
+
+TEST_F(ResourceUsageFixtureTest, measure_WhenCodeWritesAndReads_WillCountBoth)
+{
+    const auto resourceUsage = measure([this] {
+        char byte = 'x';
+        EXPECT_EQ(::write(mPipe[1], &byte, 1), 1);
+        EXPECT_EQ(::read(mPipe[0], &byte, 1), 1);
+    });
+
+    EXPECT_EQ(resourceUsage, (ResourceUsage{0, 0, 2, 1}));
+}
+
+TEST_F(ResourceUsageFixtureTest,
+       measure_WhenOtherThreadWrites_WillNotCountItsWrite)
+{
+    const auto resourceUsage = measure([this] {
+        std::thread writer{[this] {
+            char byte = 'x';
+            EXPECT_EQ(::write(mPipe[1], &byte, 1), 1);
+        }};
+        writer.join();
+    });
+
+    EXPECT_EQ(resourceUsage.writeSyscalls, 0U);
+}
@@ -0,0 +1,30 @@
+#ifndef BREAKTHEDEPENDENCY_PSEUDOTERMINAL_H
+#define BREAKTHEDEPENDENCY_PSEUDOTERMINAL_H
+
+#include <filesystem>
+
+/// A raw Linux pseudo-terminal pair. The slave end behaves like a serial
+/// device and can be opened through `asio::serial_port`, whatever is written
+/// to it can be read from the master end and vice versa.
+class PseudoTerminal
+{
+public:
+    /// Throws std::system_error if no pseudo-terminal is available
+    PseudoTerminal();
+    ~PseudoTerminal();
+
+    PseudoTerminal(const PseudoTerminal&) = delete;
+    PseudoTerminal& operator=(const PseudoTerminal&) = delete;
+
+    const std::filesystem::path& slavePath() const;
+    int masterFileDescriptor() const;
+
+private:
+    int mMaster{-1};
+    // Kept open so that reading from the master does not fail whenever the
+    // serial port that is under test closes the slave
+    int mSlave{-1};
+    std::filesystem::path mSlavePath;
+};
+
+#endif // BREAKTHEDEPENDENCY_PSEUDOTERMINAL_H
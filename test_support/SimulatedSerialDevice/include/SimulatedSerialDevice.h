@@ -0,0 +1,98 @@
+#ifndef BREAKTHEDEPENDENCY_SIMULATEDSERIALDEVICE_H
+#define BREAKTHEDEPENDENCY_SIMULATEDSERIALDEVICE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "PseudoTerminal.h"
+
+/// A device on the master end of a pseudo-terminal that the host talks to
+/// through the slave end, i.e. serialDevice(), as it would to a real one.
+class SimulatedSerialDevice
+{
+public:
+    struct Behaviour
+    {
+        /// Paces how fast the device takes bytes in, at ten bits per byte.
+        /// The host is slowed down too once the pseudo-terminal buffer fills
+        /// up, like it would be by a UART. Zero takes them in right away.
+        int baudRate{0};
+        /// Delay between a byte being taken in and the device receiving it
+        std::chrono::steady_clock::duration latency{};
+        /// Chance of losing each frame, or each byte without a delimiter
+        double dropProbability{0.0};
+        std::optional<char> frameDelimiter;
+        std::uint_fast32_t seed{std::mt19937::default_seed};
+    };
+
+    using ReceiveHandler
+        = std::function<void(std::string_view bytes,
+                             std::chrono::steady_clock::time_point receivedAt)>;
+
+    SimulatedSerialDevice();
+    /// `onReceived` runs on the device's own thread whenever bytes arrive
+    explicit SimulatedSerialDevice(Behaviour behaviour,
+                                   ReceiveHandler onReceived = {});
+    ~SimulatedSerialDevice();
+
+    const std::filesystem::path& serialDevice() const;
+
+    /// Everything received from the host so far, without the dropped bytes
+    std::string received() const;
+    std::size_t droppedBytes() const;
+    /// Blocks until `bytes` bytes from the host have been either received or
+    /// dropped. Returns false if that takes longer than `timeout`.
+    bool waitForBytesFromHost(std::size_t bytes,
+                              std::chrono::steady_clock::duration timeout
+                              = std::chrono::seconds{5}) const;
+
+    /// Writes to the host, to be read from serialDevice()
+    void sendToHost(std::string_view bytes);
+
+private:
+    struct Delivery
+    {
+        std::string bytes;
+        std::size_t droppedBytes;
+        std::chrono::steady_clock::time_point deliverAt;
+    };
+
+    void readFromHost();
+    void deliverToDevice();
+    bool waitForStopUntil(std::chrono::steady_clock::time_point deadline) const;
+    std::chrono::steady_clock::duration transmitTime(std::size_t bytes) const;
+    bool shouldDrop(char byte);
+
+    Behaviour mBehaviour;
+    ReceiveHandler mOnReceived;
+    PseudoTerminal mPseudoTerminal;
+    int mStopEvent{-1};
+    std::mt19937 mRandomEngine;
+    std::bernoulli_distribution mDrop;
+    bool mDroppingFrame{false};
+    bool mAtFrameStart{true};
+
+    mutable std::mutex mMutex;
+    mutable std::condition_variable mDeliveriesChanged;
+    mutable std::condition_variable mReceivedChanged;
+    std::deque<Delivery> mDeliveries;
+    std::string mReceived;
+    std::size_t mDroppedBytes{0};
+    bool mStopping{false};
+
+    std::thread mReader;
+    std::thread mDeliverer;
+};
+
+#endif // BREAKTHEDEPENDENCY_SIMULATEDSERIALDEVICE_H
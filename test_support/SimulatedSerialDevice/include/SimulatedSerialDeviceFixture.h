@@ -0,0 +1,17 @@
+#ifndef BREAKTHEDEPENDENCY_SIMULATEDSERIALDEVICEFIXTURE_H
+#define BREAKTHEDEPENDENCY_SIMULATEDSERIALDEVICEFIXTURE_H
+
+#include "gtest/gtest.h"
+
+#include "SimulatedSerialDevice.h"
+
+/// Gives every test a fresh simulated device without any impairments to open
+/// through `mSerialDevice` instead of real hardware
+struct SimulatedSerialDeviceFixture : public ::testing::Test
+{
+    SimulatedSerialDevice mSimulatedSerialDevice;
+    const std::filesystem::path& mSerialDevice{
+        mSimulatedSerialDevice.serialDevice()};
+};
+
+#endif // BREAKTHEDEPENDENCY_SIMULATEDSERIALDEVICEFIXTURE_H
@@ -0,0 +1,37 @@
+#include <array>
+#include <cerrno>
+#include <system_error>
+
+#include <pty.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "PseudoTerminal.h"
+
+PseudoTerminal::PseudoTerminal()
+{
+    std::array<char, 256> slaveName{};
+    termios rawMode{};
+    ::cfmakeraw(&rawMode);
+    if (::openpty(&mMaster, &mSlave, slaveName.data(), &rawMode, nullptr) != 0)
+    {
+        throw std::system_error{errno, std::generic_category(), "openpty"};
+    }
+    mSlavePath = slaveName.data();
+}
+
+PseudoTerminal::~PseudoTerminal()
+{
+    ::close(mSlave);
+    ::close(mMaster);
+}
+
+const std::filesystem::path& PseudoTerminal::slavePath() const
+{
+    return mSlavePath;
+}
+
+int PseudoTerminal::masterFileDescriptor() const
+{
+    return mMaster;
+}
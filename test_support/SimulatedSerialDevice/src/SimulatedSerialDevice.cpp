@@ -0,0 +1,247 @@
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <system_error>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "SimulatedSerialDevice.h"
+
+namespace
+{
+// Small enough for the pacing to be smooth at low baud rates
+constexpr std::size_t kReadChunkBytes = 32;
+constexpr auto kBitsPerByte = 10;
+} // namespace
+
+SimulatedSerialDevice::SimulatedSerialDevice()
+    : SimulatedSerialDevice{Behaviour{}}
+{
+}
+
+SimulatedSerialDevice::SimulatedSerialDevice(Behaviour behaviour,
+                                             ReceiveHandler onReceived)
+    : mBehaviour{behaviour}
+    , mOnReceived{std::move(onReceived)}
+    , mRandomEngine{behaviour.seed}
+    , mDrop{behaviour.dropProbability}
+{
+    mStopEvent = ::eventfd(0, EFD_CLOEXEC);
+    if (mStopEvent < 0)
+    {
+        throw std::system_error{errno, std::generic_category(), "eventfd"};
+    }
+
+    mReader = std::thread{[this] { readFromHost(); }};
+    mDeliverer = std::thread{[this] { deliverToDevice(); }};
+}
+
+SimulatedSerialDevice::~SimulatedSerialDevice()
+{
+    {
+        std::lock_guard lock{mMutex};
+        mStopping = true;
+    }
+    mDeliveriesChanged.notify_all();
+    const std::uint64_t stop = 1;
+    [[maybe_unused]] const auto written
+        = ::write(mStopEvent, &stop, sizeof(stop));
+
+    mReader.join();
+    mDeliverer.join();
+    ::close(mStopEvent);
+}
+
+const std::filesystem::path& SimulatedSerialDevice::serialDevice() const
+{
+    return mPseudoTerminal.slavePath();
+}
+
+std::string SimulatedSerialDevice::received() const
+{
+    std::lock_guard lock{mMutex};
+
+    return mReceived;
+}
+
+std::size_t SimulatedSerialDevice::droppedBytes() const
+{
+    std::lock_guard lock{mMutex};
+
+    return mDroppedBytes;
+}
+
+bool SimulatedSerialDevice::waitForBytesFromHost(
+    std::size_t bytes, std::chrono::steady_clock::duration timeout) const
+{
+    std::unique_lock lock{mMutex};
+
+    return mReceivedChanged.wait_for(lock, timeout, [this, bytes] {
+        return mReceived.size() + mDroppedBytes >= bytes;
+    });
+}
+
+void SimulatedSerialDevice::sendToHost(std::string_view bytes)
+{
+    while (!bytes.empty())
+    {
+        const auto written = ::write(mPseudoTerminal.masterFileDescriptor(),
+                                     bytes.data(),
+                                     bytes.size());
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw std::system_error{errno, std::generic_category(), "write"};
+        }
+        bytes.remove_prefix(static_cast<std::size_t>(written));
+    }
+}
+
+void SimulatedSerialDevice::readFromHost()
+{
+    std::array<char, kReadChunkBytes> chunk{};
+    auto busyUntil = std::chrono::steady_clock::now();
+    for (;;)
+    {
+        std::array<pollfd, 2> readable{
+            pollfd{mPseudoTerminal.masterFileDescriptor(), POLLIN, 0},
+            pollfd{mStopEvent, POLLIN, 0}};
+        if (::poll(readable.data(), readable.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return;
+        }
+        if (readable[1].revents != 0)
+        {
+            return;
+        }
+
+        const auto bytesRead = ::read(
+            mPseudoTerminal.masterFileDescriptor(), chunk.data(), chunk.size());
+        if (bytesRead <= 0)
+        {
+            continue;
+        }
+
+        const auto takenIn = static_cast<std::size_t>(bytesRead);
+        busyUntil = std::max(busyUntil, std::chrono::steady_clock::now())
+                    + transmitTime(takenIn);
+
+        Delivery delivery{{}, 0, busyUntil + mBehaviour.latency};
+        for (std::size_t i = 0; i < takenIn; ++i)
+        {
+            if (shouldDrop(chunk[i]))
+            {
+                ++delivery.droppedBytes;
+            }
+            else
+            {
+                delivery.bytes.push_back(chunk[i]);
+            }
+        }
+        {
+            std::lock_guard lock{mMutex};
+            mDeliveries.push_back(std::move(delivery));
+        }
+        mDeliveriesChanged.notify_all();
+
+        // Not reading any further makes the pseudo-terminal buffer fill up
+        // while the device is busy, which eventually stalls the host
+        if (waitForStopUntil(busyUntil))
+        {
+            return;
+        }
+    }
+}
+
+void SimulatedSerialDevice::deliverToDevice()
+{
+    std::unique_lock lock{mMutex};
+    for (;;)
+    {
+        mDeliveriesChanged.wait(
+            lock, [this] { return mStopping || !mDeliveries.empty(); });
+        if (mStopping)
+        {
+            return;
+        }
+
+        const auto deliverAt = mDeliveries.front().deliverAt;
+        if (mDeliveriesChanged.wait_until(
+                lock, deliverAt, [this] { return mStopping; }))
+        {
+            return;
+        }
+
+        auto delivery = std::move(mDeliveries.front());
+        mDeliveries.pop_front();
+        if (mOnReceived && !delivery.bytes.empty())
+        {
+            lock.unlock();
+            mOnReceived(delivery.bytes, std::chrono::steady_clock::now());
+            lock.lock();
+        }
+        mReceived += delivery.bytes;
+        mDroppedBytes += delivery.droppedBytes;
+        mReceivedChanged.notify_all();
+    }
+}
+
+bool SimulatedSerialDevice::waitForStopUntil(
+    std::chrono::steady_clock::time_point deadline) const
+{
+    for (auto now = std::chrono::steady_clock::now(); now < deadline;
+         now = std::chrono::steady_clock::now())
+    {
+        const auto remaining
+            = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline
+                                                                   - now);
+        const timespec timeout{
+            static_cast<time_t>(remaining.count() / 1'000'000'000),
+            static_cast<long>(remaining.count() % 1'000'000'000)};
+        pollfd stop{mStopEvent, POLLIN, 0};
+        if (::ppoll(&stop, 1, &timeout, nullptr) > 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::chrono::steady_clock::duration
+SimulatedSerialDevice::transmitTime(std::size_t bytes) const
+{
+    if (mBehaviour.baudRate <= 0)
+    {
+        return {};
+    }
+
+    return std::chrono::nanoseconds{static_cast<std::int64_t>(bytes)
+                                    * kBitsPerByte * 1'000'000'000
+                                    / mBehaviour.baudRate};
+}
+
+bool SimulatedSerialDevice::shouldDrop(char byte)
+{
+    if (!mBehaviour.frameDelimiter)
+    {
+        return mDrop(mRandomEngine);
+    }
+
+    if (mAtFrameStart)
+    {
+        mDroppingFrame = mDrop(mRandomEngine);
+    }
+    mAtFrameStart = byte == *mBehaviour.frameDelimiter;
+
+    return mDroppingFrame;
+}
@@ -0,0 +1,128 @@
+#include <chrono>
+#include <string>
+
+#include <asio.hpp>
+
+#include "gtest/gtest.h"
+
+#include "SimulatedSerialDeviceFixture.h"
+
+using namespace std::literals;
+
+namespace
+{
+void writeToSerialDevice(const std::filesystem::path& serialDevice,
+                         std::string_view bytes)
+{
+    asio::io_context ioContext;
+    asio::serial_port serialPort{ioContext, serialDevice.string()};
+    asio::write(serialPort, asio::buffer(bytes.data(), bytes.size()));
+}
+} // namespace
+
+TEST_F(SimulatedSerialDeviceFixture, received_WhenHostWrites_WillReceiveBytes)
+{
+    writeToSerialDevice(mSerialDevice, "ONOFF");
+
+    ASSERT_TRUE(mSimulatedSerialDevice.waitForBytesFromHost(5));
+    EXPECT_EQ(mSimulatedSerialDevice.received(), "ONOFF");
+    EXPECT_EQ(mSimulatedSerialDevice.droppedBytes(), 0U);
+}
+
+TEST_F(SimulatedSerialDeviceFixture,
+       sendToHost_WhenCalled_WillBeReadFromSerialDevice)
+{
+    asio::io_context ioContext;
+    asio::serial_port serialPort{ioContext, mSerialDevice.string()};
+
+    mSimulatedSerialDevice.sendToHost("OK");
+
+    std::string response(2, '\0');
+    asio::read(serialPort, asio::buffer(response));
+    EXPECT_EQ(response, "OK");
+}
+
+TEST(SimulatedSerialDeviceTest,
+     received_WhenBaudRatePaced_WillTakeAtLeastTheTransmitTime)
+{
+    // 48 bytes at ten bits per byte take 50ms at 9600 baud
+    SimulatedSerialDevice::Behaviour behaviour;
+    behaviour.baudRate = 9600;
+    SimulatedSerialDevice simulatedSerialDevice{behaviour};
+    const std::string message(48, 'x');
+
+    const auto start = std::chrono::steady_clock::now();
+    writeToSerialDevice(simulatedSerialDevice.serialDevice(), message);
+    ASSERT_TRUE(simulatedSerialDevice.waitForBytesFromHost(message.size()));
+
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 50ms);
+    EXPECT_EQ(simulatedSerialDevice.received(), message);
+}
+
+TEST(SimulatedSerialDeviceTest, received_WhenLatencyConfigured_WillBeDelayed)
+{
+    SimulatedSerialDevice::Behaviour behaviour;
+    behaviour.latency = 50ms;
+    SimulatedSerialDevice simulatedSerialDevice{behaviour};
+
+    const auto start = std::chrono::steady_clock::now();
+    writeToSerialDevice(simulatedSerialDevice.serialDevice(), "ON");
+    ASSERT_TRUE(simulatedSerialDevice.waitForBytesFromHost(2));
+
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 50ms);
+    EXPECT_EQ(simulatedSerialDevice.received(), "ON");
+}
+
+TEST(SimulatedSerialDeviceTest,
+     received_WhenFramesDropped_WillOnlyLoseWholeFrames)
+{
+    SimulatedSerialDevice::Behaviour behaviour;
+    behaviour.dropProbability = 0.5;
+    behaviour.frameDelimiter = '\n';
+    SimulatedSerialDevice simulatedSerialDevice{behaviour};
+    std::string frames;
+    for (auto i = 0; i < 100; ++i)
+    {
+        frames += "ON\n";
+    }
+
+    writeToSerialDevice(simulatedSerialDevice.serialDevice(), frames);
+    ASSERT_TRUE(simulatedSerialDevice.waitForBytesFromHost(frames.size()));
+
+    const auto received = simulatedSerialDevice.received();
+    EXPECT_GT(simulatedSerialDevice.droppedBytes(), 0U);
+    EXPECT_EQ(received.size() + simulatedSerialDevice.droppedBytes(),
+              frames.size());
+    EXPECT_EQ(received.size() % 3, 0U);
+    EXPECT_EQ(received, frames.substr(0, received.size()));
+}
+
+TEST(SimulatedSerialDeviceTest, received_WhenEveryByteDropped_WillBeEmpty)
+{
+    SimulatedSerialDevice::Behaviour behaviour;
+    behaviour.dropProbability = 1.0;
+    SimulatedSerialDevice simulatedSerialDevice{behaviour};
+
+    writeToSerialDevice(simulatedSerialDevice.serialDevice(), "ONOFF");
+    ASSERT_TRUE(simulatedSerialDevice.waitForBytesFromHost(5));
+
+    EXPECT_TRUE(simulatedSerialDevice.received().empty());
+    EXPECT_EQ(simulatedSerialDevice.droppedBytes(), 5U);
+}
+
+TEST(SimulatedSerialDeviceTest, onReceived_WhenHostWrites_WillBeInvoked)
+{
+    std::string handled;
+    std::mutex handledMutex;
+    SimulatedSerialDevice simulatedSerialDevice{
+        {}, [&](std::string_view bytes, std::chrono::steady_clock::time_point) {
+            std::lock_guard lock{handledMutex};
+            handled += bytes;
+        }};
+
+    writeToSerialDevice(simulatedSerialDevice.serialDevice(), "ON");
+    ASSERT_TRUE(simulatedSerialDevice.waitForBytesFromHost(2));
+
+    std::lock_guard lock{handledMutex};
+    EXPECT_EQ(handled, "ON");
+}